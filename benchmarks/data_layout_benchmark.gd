@@ -0,0 +1,102 @@
+extends SceneTree
+
+# Meshes the same terrain with every data layout, and prints the time each step takes.
+# Run it with a godot binary that contains voxelman:
+#   godot --no-window --script modules/voxelman/benchmarks/data_layout_benchmark.gd
+# To see the cache misses themselves run it under perf:
+#   perf stat -e cache-references,cache-misses godot --no-window --script ... -- linear
+# Passing a layout name after "--" only runs that layout, so the counters can be compared.
+
+const CHUNK_SIZE : int = 32
+const MARGIN_START : int = 1
+const MARGIN_END : int = 2
+const ITERATIONS : int = 20
+
+const LAYOUT_NAMES : Array = [ "linear", "brick_4", "brick_8", "morton" ]
+
+var library : VoxelmanLibrarySimple = null
+
+func _init() -> void:
+	library = VoxelmanLibrarySimple.new()
+
+	for i in range(2):
+		library.voxel_surface_add(VoxelSurfaceSimple.new())
+
+	var layouts : Array = [ VoxelChunk.DATA_LAYOUT_LINEAR, VoxelChunk.DATA_LAYOUT_BRICK_4, VoxelChunk.DATA_LAYOUT_BRICK_8, VoxelChunk.DATA_LAYOUT_MORTON ]
+
+	var args : PoolStringArray = OS.get_cmdline_args()
+
+	for i in range(layouts.size()):
+		var selected : bool = true
+
+		for arg in args:
+			if arg in LAYOUT_NAMES:
+				selected = arg == LAYOUT_NAMES[i]
+
+		if selected:
+			run_layout(layouts[i], LAYOUT_NAMES[i])
+
+	quit()
+
+func run_layout(layout : int, name : String) -> void:
+	var chunk : VoxelChunkDefault = VoxelChunkDefault.new()
+
+	# Dense channels, so only the memory order differs between the runs
+	chunk.channel_packing = false
+	chunk.data_layout = layout
+	chunk.set_size(CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE, MARGIN_START, MARGIN_END)
+
+	fill_chunk(chunk)
+
+	var blocky : VoxelMesherBlocky = VoxelMesherBlocky.new()
+	blocky.library = library
+	blocky.channel_index_type = VoxelChunkDefault.DEFAULT_CHANNEL_TYPE
+
+	var cubic : VoxelMesherCubic = VoxelMesherCubic.new()
+	cubic.library = library
+	cubic.channel_index_type = VoxelChunkDefault.DEFAULT_CHANNEL_TYPE
+	cubic.channel_index_isolevel = VoxelChunkDefault.DEFAULT_CHANNEL_ISOLEVEL
+
+	var job : VoxelTerrarinJob = VoxelTerrarinJob.new()
+	job.set_chunk(chunk)
+
+	var blocky_time : int = 0
+	var cubic_time : int = 0
+	var ao_time : int = 0
+
+	for i in range(ITERATIONS):
+		var t : int = OS.get_ticks_usec()
+		blocky.add_chunk(chunk)
+		blocky_time += OS.get_ticks_usec() - t
+		blocky.reset()
+
+		t = OS.get_ticks_usec()
+		cubic.add_chunk(chunk)
+		cubic_time += OS.get_ticks_usec() - t
+		cubic.reset()
+
+		t = OS.get_ticks_usec()
+		job.generate_ao()
+		ao_time += OS.get_ticks_usec() - t
+
+	print("%-8s blocky: %7.1f us  cubic: %7.1f us  ao: %7.1f us  channel memory: %d bytes" % [
+		name, float(blocky_time) / ITERATIONS, float(cubic_time) / ITERATIONS, float(ao_time) / ITERATIONS, chunk.get_memory_usage() ])
+
+# Rolling hills, with two voxel types, so every mesher has surfaces to generate
+func fill_chunk(chunk : VoxelChunkDefault) -> void:
+	var noise : OpenSimplexNoise = OpenSimplexNoise.new()
+	noise.seed = 1234
+	noise.period = 24
+
+	var data_size : int = CHUNK_SIZE + MARGIN_START + MARGIN_END
+
+	for x in range(-MARGIN_START, CHUNK_SIZE + MARGIN_END):
+		for z in range(-MARGIN_START, CHUNK_SIZE + MARGIN_END):
+			var height : float = (noise.get_noise_2d(x, z) * 0.5 + 0.5) * data_size
+
+			for y in range(-MARGIN_START, CHUNK_SIZE + MARGIN_END):
+				if y > height:
+					continue
+
+				chunk.set_voxel(1 if y > height - 3 else 2, x, y, z, VoxelChunkDefault.DEFAULT_CHANNEL_TYPE)
+				chunk.set_voxel(int(clamp(height - y, 0, 1) * 255), x, y, z, VoxelChunkDefault.DEFAULT_CHANNEL_ISOLEVEL)
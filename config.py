@@ -37,6 +37,9 @@ def get_doc_classes():
         "EnvironmentData",
         "VoxelChunk",
         "VoxelChunkDefault",
+        "VoxelBufferPool",
+        "VoxelRegionStore",
+        "VoxelWorldPack",
         "VoxelStructure",
         "BlockVoxelStructure",
         "VoxelWorld",
@@ -66,8 +66,10 @@ void VoxelmanLevelGeneratorFlat::_generate_chunk(Ref<VoxelChunk> chunk) {
 
 		uint8_t *channel = chunk->channel_get_valid(k, 0);
 
-		if (!channel)
+		if (!channel) {
+			keyptr = _channel_map.next(keyptr);
 			continue;
+		}
 
 		int ty = _floor_position - dymin;
 		for (int y = 0; y < ty; ++y) {
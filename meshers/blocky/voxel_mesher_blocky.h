@@ -52,6 +52,9 @@ protected:
 	static void _bind_methods();
 
 private:
+	template <bool WIDE>
+	void _add_chunk_width(const Ref<VoxelChunk> &p_chunk);
+
 	bool _always_add_colors;
 };
 
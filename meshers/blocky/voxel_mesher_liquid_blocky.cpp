@@ -25,6 +25,16 @@ SOFTWARE.
 #include "../../world/default/voxel_chunk_default.h"
 
 void VoxelMesherLiquidBlocky::_add_chunk(Ref<VoxelChunk> p_chunk) {
+	ERR_FAIL_COND(!p_chunk.is_valid());
+
+	if (p_chunk->channel_get_high_snapshot(_channel_index_type))
+		_add_chunk_width<true>(p_chunk);
+	else
+		_add_chunk_width<false>(p_chunk);
+}
+
+template <bool WIDE>
+void VoxelMesherLiquidBlocky::_add_chunk_width(const Ref<VoxelChunk> &p_chunk) {
 	Ref<VoxelChunkDefault> chunk = p_chunk;
 
 	ERR_FAIL_COND(!chunk.is_valid());
@@ -38,11 +48,18 @@ void VoxelMesherLiquidBlocky::_add_chunk(Ref<VoxelChunk> p_chunk) {
 
 	float voxel_scale = get_voxel_scale();
 
-	uint8_t *channel_type = chunk->channel_get(VoxelChunkDefault::DEFAULT_CHANNEL_TYPE);
+	//Only faces between different types are generated, a uniform chunk has none
+	if (chunk->channel_is_uniform_snapshot(_channel_index_type))
+		return;
+
+	uint8_t *channel_type = chunk->channel_get_snapshot(_channel_index_type);
 
 	if (!channel_type)
 		return;
 
+	//Only set for 16 bit type channels that actually use the high bytes
+	uint8_t *channel_type_high = chunk->channel_get_high_snapshot(_channel_index_type);
+
 	uint8_t *channel_color_r = NULL;
 	uint8_t *channel_color_g = NULL;
 	uint8_t *channel_color_b = NULL;
@@ -67,7 +84,7 @@ void VoxelMesherLiquidBlocky::_add_chunk(Ref<VoxelChunk> p_chunk) {
 			channel_rao = chunk->channel_get(VoxelChunkDefault::DEFAULT_CHANNEL_RANDOM_AO);
 	}
 
-	Vector<uint8_t> liquids;
+	Vector<int> liquids;
 	for (int i = 0; i < _library->voxel_surface_get_num(); ++i) {
 		Ref<VoxelSurface> surface = _library->voxel_surface_get(i);
 
@@ -75,7 +92,7 @@ void VoxelMesherLiquidBlocky::_add_chunk(Ref<VoxelChunk> p_chunk) {
 			continue;
 
 		if (surface->get_liquid())
-			liquids.push_back(static_cast<uint8_t>(i + 1));
+			liquids.push_back(i + 1);
 	}
 
 	for (int y = chunk->get_margin_start(); y < y_size + chunk->get_margin_start(); ++y) {
@@ -90,7 +107,7 @@ void VoxelMesherLiquidBlocky::_add_chunk(Ref<VoxelChunk> p_chunk) {
 				int indexzp = chunk->get_data_index(x, y, z + 1);
 				int indexzn = chunk->get_data_index(x, y, z - 1);
 
-				uint8_t type = channel_type[index];
+				int type = VoxelChunk::decode_voxel16<WIDE>(channel_type, channel_type_high, index);
 
 				if (type == 0)
 					continue;
@@ -103,13 +120,13 @@ void VoxelMesherLiquidBlocky::_add_chunk(Ref<VoxelChunk> p_chunk) {
 				if (!surface.is_valid())
 					continue;
 
-				uint8_t neighbours[] = {
-					channel_type[indexxp],
-					channel_type[indexxn],
-					channel_type[indexyp],
-					channel_type[indexyn],
-					channel_type[indexzp],
-					channel_type[indexzn],
+				int neighbours[] = {
+					VoxelChunk::decode_voxel16<WIDE>(channel_type, channel_type_high, indexxp),
+					VoxelChunk::decode_voxel16<WIDE>(channel_type, channel_type_high, indexxn),
+					VoxelChunk::decode_voxel16<WIDE>(channel_type, channel_type_high, indexyp),
+					VoxelChunk::decode_voxel16<WIDE>(channel_type, channel_type_high, indexyn),
+					VoxelChunk::decode_voxel16<WIDE>(channel_type, channel_type_high, indexzp),
+					VoxelChunk::decode_voxel16<WIDE>(channel_type, channel_type_high, indexzn),
 				};
 
 				//x + 1
@@ -47,6 +47,10 @@ public:
 
 protected:
 	static void _bind_methods();
+
+private:
+	template <bool WIDE>
+	void _add_chunk_width(const Ref<VoxelChunk> &p_chunk);
 };
 
 #endif
@@ -206,9 +206,39 @@ void VoxelCubePoints::recalculate_point(int point) {
 	_points[point] = dynamic_offset;
 }
 
+_FORCE_INLINE_ uint8_t VoxelCubePoints::_get_voxel(const Ref<VoxelChunk> &chunk, const int x, const int y, const int z, const int channel_index) const {
+	if (_unchecked)
+		return chunk->get_voxel_unchecked(x, y, z, channel_index);
+
+	return chunk->get_voxel(x, y, z, channel_index);
+}
+
+//The shape comes from the build's snapshot, lights, and ao are written by the build itself
+_FORCE_INLINE_ uint8_t VoxelCubePoints::_get_voxel_snapshot(const Ref<VoxelChunk> &chunk, const int x, const int y, const int z, const int channel_index) const {
+	if (_unchecked)
+		return chunk->get_voxel_snapshot_unchecked(x, y, z, channel_index);
+
+	return chunk->get_voxel_snapshot(x, y, z, channel_index);
+}
+
+//Types can be 16 bit, the high bytes are only read when the channel uses them
+_FORCE_INLINE_ int VoxelCubePoints::_get_type(const Ref<VoxelChunk> &chunk, const int x, const int y, const int z) const {
+	int type = _get_voxel_snapshot(chunk, x, y, z, _channel_index_type);
+
+	if (_type_high && (_unchecked || chunk->validate_region(x, y, z, 1, 1, 1)))
+		type |= _type_high[chunk->get_index(x, y, z)] << 8;
+
+	return type;
+}
+
 void VoxelCubePoints::refresh_neighbours(Ref<VoxelChunk> chunk) {
 	ERR_FAIL_COND(!chunk.is_valid());
 
+	_unchecked = _channel_index_type >= 0 && _channel_index_type < chunk->channel_get_count() &&
+				 chunk->validate_region(_x - 1, _y - 1, _z - 1, 4, 4, 4);
+
+	_type_high = _channel_index_type >= 0 && _channel_index_type < chunk->channel_get_count() ? chunk->channel_get_high_snapshot(_channel_index_type) : NULL;
+
 	int neighbours = 0;
 
 	int x = _x;
@@ -216,25 +246,25 @@ void VoxelCubePoints::refresh_neighbours(Ref<VoxelChunk> chunk) {
 	int z = _z;
 
 	//000
-	if (chunk->get_voxel(x - 1, y, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_LEFT;
 
-	if (chunk->get_voxel(x, y - 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y - 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM;
 
-	if (chunk->get_voxel(x, y, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_FRONT;
 	/*
-	if (chunk->get_voxel(x - 1, y, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_LEFT_FRONT;
 
-	if (chunk->get_voxel(x - 1, y - 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y - 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_LEFT;
 
-	if (chunk->get_voxel(x, y - 1, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y - 1, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_FRONT;
 
-	if (chunk->get_voxel(x - 1, y - 1, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y - 1, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_LEFT_FRONT;*/
 
 	_point_neighbours[P000] = neighbours;
@@ -245,25 +275,25 @@ void VoxelCubePoints::refresh_neighbours(Ref<VoxelChunk> chunk) {
 	z = _z;
 
 	//100
-	if (chunk->get_voxel(x + 1, y, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_RIGHT;
 
-	if (chunk->get_voxel(x, y - 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y - 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM;
 
-	if (chunk->get_voxel(x, y, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_FRONT;
 	/*
-	if (chunk->get_voxel(x + 1, y, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_RIGHT_FRONT;
 
-	if (chunk->get_voxel(x + 1, y - 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y - 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_RIGHT;
 
-	if (chunk->get_voxel(x, y - 1, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y - 1, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_FRONT;
 
-	if (chunk->get_voxel(x + 1, y - 1, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y - 1, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_RIGHT_FRONT;*/
 
 	_point_neighbours[P100] = neighbours;
@@ -274,25 +304,25 @@ void VoxelCubePoints::refresh_neighbours(Ref<VoxelChunk> chunk) {
 	z = _z;
 
 	//010
-	if (chunk->get_voxel(x - 1, y, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_LEFT;
 
-	if (chunk->get_voxel(x, y + 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y + 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP;
 
-	if (chunk->get_voxel(x, y, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_FRONT;
 	/*
-	if (chunk->get_voxel(x - 1, y, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_LEFT_FRONT;
 
-	if (chunk->get_voxel(x - 1, y + 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y + 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_LEFT;
 
-	if (chunk->get_voxel(x, y + 1, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y + 1, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_FRONT;
 
-	if (chunk->get_voxel(x - 1, y + 1, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y + 1, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_LEFT_FRONT;*/
 
 	_point_neighbours[P010] = neighbours;
@@ -303,25 +333,25 @@ void VoxelCubePoints::refresh_neighbours(Ref<VoxelChunk> chunk) {
 	z = _z;
 
 	//110
-	if (chunk->get_voxel(x + 1, y, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_RIGHT;
 
-	if (chunk->get_voxel(x, y + 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y + 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP;
 
-	if (chunk->get_voxel(x, y, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_FRONT;
 	/*
-	if (chunk->get_voxel(x + 1, y, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_RIGHT_FRONT;
 
-	if (chunk->get_voxel(x + 1, y + 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y + 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_RIGHT;
 
-	if (chunk->get_voxel(x, y + 1, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y + 1, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_FRONT;
 
-	if (chunk->get_voxel(x + 1, y + 1, z - 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y + 1, z - 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_RIGHT_FRONT;*/
 
 	_point_neighbours[P110] = neighbours;
@@ -332,25 +362,25 @@ void VoxelCubePoints::refresh_neighbours(Ref<VoxelChunk> chunk) {
 	z = _z + 1;
 
 	//001
-	if (chunk->get_voxel(x - 1, y, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_LEFT;
 
-	if (chunk->get_voxel(x, y - 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y - 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM;
 
-	if (chunk->get_voxel(x, y, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BACK;
 	/*
-	if (chunk->get_voxel(x - 1, y, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_LEFT_BACK;
 
-	if (chunk->get_voxel(x - 1, y - 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y - 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_LEFT;
 
-	if (chunk->get_voxel(x, y - 1, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y - 1, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_BACK;
 
-	if (chunk->get_voxel(x - 1, y - 1, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y - 1, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_LEFT_BACK;*/
 
 	_point_neighbours[P001] = neighbours;
@@ -361,25 +391,25 @@ void VoxelCubePoints::refresh_neighbours(Ref<VoxelChunk> chunk) {
 	z = _z + 1;
 
 	//101
-	if (chunk->get_voxel(x + 1, y, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_RIGHT;
 
-	if (chunk->get_voxel(x, y - 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y - 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM;
 
-	if (chunk->get_voxel(x, y, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BACK;
 	/*
-	if (chunk->get_voxel(x + 1, y, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_RIGHT_BACK;
 
-	if (chunk->get_voxel(x + 1, y - 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y - 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_RIGHT;
 
-	if (chunk->get_voxel(x, y - 1, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y - 1, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_BACK;
 
-	if (chunk->get_voxel(x + 1, y - 1, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y - 1, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BOTTOM_RIGHT_BACK;*/
 
 	_point_neighbours[P101] = neighbours;
@@ -390,25 +420,25 @@ void VoxelCubePoints::refresh_neighbours(Ref<VoxelChunk> chunk) {
 	z = _z + 1;
 
 	//011
-	if (chunk->get_voxel(x - 1, y, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_LEFT;
 
-	if (chunk->get_voxel(x, y + 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y + 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP;
 
-	if (chunk->get_voxel(x, y, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BACK;
 	/*
-	if (chunk->get_voxel(x - 1, y, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_LEFT_BACK;
 
-	if (chunk->get_voxel(x - 1, y + 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y + 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_LEFT;
 
-	if (chunk->get_voxel(x, y + 1, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y + 1, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_BACK;
 
-	if (chunk->get_voxel(x - 1, y + 1, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x - 1, y + 1, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_LEFT_BACK;*/
 
 	_point_neighbours[P011] = neighbours;
@@ -419,25 +449,25 @@ void VoxelCubePoints::refresh_neighbours(Ref<VoxelChunk> chunk) {
 	z = _z + 1;
 
 	//111
-	if (chunk->get_voxel(x + 1, y, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_RIGHT;
 
-	if (chunk->get_voxel(x, y + 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y + 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP;
 
-	if (chunk->get_voxel(x, y, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_BACK;
 	/*
-	if (chunk->get_voxel(x + 1, y, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_RIGHT_BACK;
 
-	if (chunk->get_voxel(x + 1, y + 1, z, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y + 1, z) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_RIGHT;
 
-	if (chunk->get_voxel(x, y + 1, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x, y + 1, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_BACK;
 
-	if (chunk->get_voxel(x + 1, y + 1, z + 1, _channel_index_type) != 0)
+	if (_get_type(chunk, x + 1, y + 1, z + 1) != 0)
 		neighbours = neighbours | VOXEL_NEIGHBOUR_TOP_RIGHT_BACK;*/
 
 	_point_neighbours[P111] = neighbours;
@@ -455,14 +485,22 @@ void VoxelCubePoints::setup(Ref<VoxelChunk> chunk, int x, int y, int z, int size
 	_z = z;
 	_size = size;
 
-	_point_types[P000] = chunk->get_voxel(x, y, z, _channel_index_type);
-	_point_types[P100] = chunk->get_voxel(x + size, y, z, _channel_index_type);
-	_point_types[P010] = chunk->get_voxel(x, y + size, z, _channel_index_type);
-	_point_types[P001] = chunk->get_voxel(x, y, z + size, _channel_index_type);
-	_point_types[P110] = chunk->get_voxel(x + size, y + size, z, _channel_index_type);
-	_point_types[P011] = chunk->get_voxel(x, y + size, z + size, _channel_index_type);
-	_point_types[P101] = chunk->get_voxel(x + size, y, z + size, _channel_index_type);
-	_point_types[P111] = chunk->get_voxel(x + size, y + size, z + size, _channel_index_type);
+	//One bounds check for the whole cube, and it's neighbours
+	int max_channel = MAX(MAX(_channel_index_type, _channel_index_isolevel), static_cast<int>(VoxelChunkDefault::DEFAULT_CHANNEL_AO));
+
+	_unchecked = _channel_index_type >= 0 && _channel_index_isolevel >= 0 && max_channel < chunk->channel_get_count() &&
+				 chunk->validate_region(x - 1, y - 1, z - 1, MAX(size, 2) + 2, MAX(size, 2) + 2, MAX(size, 2) + 2);
+
+	_type_high = _channel_index_type >= 0 && _channel_index_type < chunk->channel_get_count() ? chunk->channel_get_high_snapshot(_channel_index_type) : NULL;
+
+	_point_types[P000] = _get_type(chunk, x, y, z);
+	_point_types[P100] = _get_type(chunk, x + size, y, z);
+	_point_types[P010] = _get_type(chunk, x, y + size, z);
+	_point_types[P001] = _get_type(chunk, x, y, z + size);
+	_point_types[P110] = _get_type(chunk, x + size, y + size, z);
+	_point_types[P011] = _get_type(chunk, x, y + size, z + size);
+	_point_types[P101] = _get_type(chunk, x + size, y, z + size);
+	_point_types[P111] = _get_type(chunk, x + size, y + size, z + size);
 
 	if (!has_points())
 		return;
@@ -473,14 +511,14 @@ void VoxelCubePoints::setup(Ref<VoxelChunk> chunk, int x, int y, int z, int size
 	//	}
 	//}
 
-	_point_fills[P000] = chunk->get_voxel(x, y, z, _channel_index_isolevel);
-	_point_fills[P100] = chunk->get_voxel(x + size, y, z, _channel_index_isolevel);
-	_point_fills[P010] = chunk->get_voxel(x, y + size, z, _channel_index_isolevel);
-	_point_fills[P001] = chunk->get_voxel(x, y, z + size, _channel_index_isolevel);
-	_point_fills[P110] = chunk->get_voxel(x + size, y + size, z, _channel_index_isolevel);
-	_point_fills[P011] = chunk->get_voxel(x, y + size, z + size, _channel_index_isolevel);
-	_point_fills[P101] = chunk->get_voxel(x + size, y, z + size, _channel_index_isolevel);
-	_point_fills[P111] = chunk->get_voxel(x + size, y + size, z + size, _channel_index_isolevel);
+	_point_fills[P000] = _get_voxel_snapshot(chunk, x, y, z, _channel_index_isolevel);
+	_point_fills[P100] = _get_voxel_snapshot(chunk, x + size, y, z, _channel_index_isolevel);
+	_point_fills[P010] = _get_voxel_snapshot(chunk, x, y + size, z, _channel_index_isolevel);
+	_point_fills[P001] = _get_voxel_snapshot(chunk, x, y, z + size, _channel_index_isolevel);
+	_point_fills[P110] = _get_voxel_snapshot(chunk, x + size, y + size, z, _channel_index_isolevel);
+	_point_fills[P011] = _get_voxel_snapshot(chunk, x, y + size, z + size, _channel_index_isolevel);
+	_point_fills[P101] = _get_voxel_snapshot(chunk, x + size, y, z + size, _channel_index_isolevel);
+	_point_fills[P111] = _get_voxel_snapshot(chunk, x + size, y + size, z + size, _channel_index_isolevel);
 
 	//for (int i = 0; i < 8; ++i) {
 	//	if (_point_fills[i] == 0) {
@@ -488,23 +526,23 @@ void VoxelCubePoints::setup(Ref<VoxelChunk> chunk, int x, int y, int z, int size
 	//	}
 	//}
 
-	_point_aos[P000] = chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
-	_point_aos[P100] = chunk->get_voxel(x + size, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
-	_point_aos[P010] = chunk->get_voxel(x, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
-	_point_aos[P001] = chunk->get_voxel(x, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
-	_point_aos[P110] = chunk->get_voxel(x + size, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
-	_point_aos[P011] = chunk->get_voxel(x, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
-	_point_aos[P101] = chunk->get_voxel(x + size, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
-	_point_aos[P111] = chunk->get_voxel(x + size, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
-
-	_point_colors[P000] = Color(chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
-	_point_colors[P100] = Color(chunk->get_voxel(x + size, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, chunk->get_voxel(x + size, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, chunk->get_voxel(x + size, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
-	_point_colors[P010] = Color(chunk->get_voxel(x, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, chunk->get_voxel(x, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, chunk->get_voxel(x, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
-	_point_colors[P001] = Color(chunk->get_voxel(x, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, chunk->get_voxel(x, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, chunk->get_voxel(x, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
-	_point_colors[P110] = Color(chunk->get_voxel(x + size, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, chunk->get_voxel(x + size, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, chunk->get_voxel(x + size, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
-	_point_colors[P011] = Color(chunk->get_voxel(x, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, chunk->get_voxel(x, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, chunk->get_voxel(x, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
-	_point_colors[P101] = Color(chunk->get_voxel(x + size, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, chunk->get_voxel(x + size, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, chunk->get_voxel(x + size, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
-	_point_colors[P111] = Color(chunk->get_voxel(x + size, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, chunk->get_voxel(x + size, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, chunk->get_voxel(x + size, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
+	_point_aos[P000] = _get_voxel(chunk, x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
+	_point_aos[P100] = _get_voxel(chunk, x + size, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
+	_point_aos[P010] = _get_voxel(chunk, x, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
+	_point_aos[P001] = _get_voxel(chunk, x, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
+	_point_aos[P110] = _get_voxel(chunk, x + size, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
+	_point_aos[P011] = _get_voxel(chunk, x, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
+	_point_aos[P101] = _get_voxel(chunk, x + size, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
+	_point_aos[P111] = _get_voxel(chunk, x + size, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
+
+	_point_colors[P000] = Color(_get_voxel(chunk, x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, _get_voxel(chunk, x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, _get_voxel(chunk, x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
+	_point_colors[P100] = Color(_get_voxel(chunk, x + size, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, _get_voxel(chunk, x + size, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, _get_voxel(chunk, x + size, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
+	_point_colors[P010] = Color(_get_voxel(chunk, x, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, _get_voxel(chunk, x, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, _get_voxel(chunk, x, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
+	_point_colors[P001] = Color(_get_voxel(chunk, x, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, _get_voxel(chunk, x, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, _get_voxel(chunk, x, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
+	_point_colors[P110] = Color(_get_voxel(chunk, x + size, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, _get_voxel(chunk, x + size, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, _get_voxel(chunk, x + size, y + size, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
+	_point_colors[P011] = Color(_get_voxel(chunk, x, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, _get_voxel(chunk, x, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, _get_voxel(chunk, x, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
+	_point_colors[P101] = Color(_get_voxel(chunk, x + size, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, _get_voxel(chunk, x + size, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, _get_voxel(chunk, x + size, y, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
+	_point_colors[P111] = Color(_get_voxel(chunk, x + size, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0, _get_voxel(chunk, x + size, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0, _get_voxel(chunk, x + size, y + size, z + size, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
 
 	refresh_neighbours(chunk);
 
@@ -754,7 +792,7 @@ Vector3 VoxelCubePoints::get_bottom_right_point(int face) {
 	return _points[P000];
 }
 
-uint8_t VoxelCubePoints::get_face_type(int face) {
+int VoxelCubePoints::get_face_type(int face) {
 	if (face == VOXEL_FACE_BACK) {
 		return _point_types[P111];
 	}
@@ -807,6 +845,8 @@ int VoxelCubePoints::get_opposite_face(int face) {
 VoxelCubePoints::VoxelCubePoints() {
 	_channel_index_type = 0;
 	_channel_index_isolevel = 0;
+	_unchecked = false;
+	_type_high = NULL;
 
 	reset();
 }
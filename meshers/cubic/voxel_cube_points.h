@@ -160,7 +160,7 @@ public:
 	Vector3 get_bottom_left_point(int face);
 	Vector3 get_bottom_right_point(int face);
 
-	uint8_t get_face_type(int face);
+	int get_face_type(int face);
 
 	bool has_points();
 	int get_opposite_face(int face);
@@ -178,13 +178,23 @@ protected:
 	static const unsigned int point_direction_neighbour_table[8][3];
 	static const float uv_direction_table[8][4][2];
 
+	uint8_t _get_voxel(const Ref<VoxelChunk> &chunk, const int x, const int y, const int z, const int channel_index) const;
+	uint8_t _get_voxel_snapshot(const Ref<VoxelChunk> &chunk, const int x, const int y, const int z, const int channel_index) const;
+	int _get_type(const Ref<VoxelChunk> &chunk, const int x, const int y, const int z) const;
+
 private:
 	int _channel_index_type;
 	int _channel_index_isolevel;
 
+	//Set when every voxel the current cube reads is inside the chunk's data
+	bool _unchecked;
+
+	//The type channel's high bytes, NULL unless it's a 16 bit channel that uses them
+	const uint8_t *_type_high;
+
 	Vector3 _points[POINT_COUNT];
 
-	uint8_t _point_types[POINT_COUNT];
+	uint16_t _point_types[POINT_COUNT];
 	uint8_t _point_fills[POINT_COUNT];
 	uint8_t _point_aos[POINT_COUNT];
 	Color _point_colors[POINT_COUNT];
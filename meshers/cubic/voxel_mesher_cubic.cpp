@@ -33,7 +33,11 @@ void VoxelMesherCubic::_add_chunk(Ref<VoxelChunk> p_chunk) {
 
 	ERR_FAIL_COND(!chunk.is_valid());
 
-	if (!chunk->channel_get(_channel_index_type) || !chunk->channel_get(_channel_index_isolevel)) {
+	if (!chunk->channel_is_allocated(_channel_index_type) || !chunk->channel_is_allocated(_channel_index_isolevel)) {
+		return;
+	}
+
+	if (chunk->channel_is_uniform_snapshot(_channel_index_type) && chunk->get_voxel_snapshot(0, 0, 0, _channel_index_type) == 0) {
 		return;
 	}
 
@@ -68,7 +72,7 @@ void VoxelMesherCubic::_add_chunk(Ref<VoxelChunk> p_chunk) {
 					if (!cube_points->is_face_visible(face))
 						continue;
 
-					uint8_t type = cube_points->get_face_type(face) - 1;
+					int type = cube_points->get_face_type(face) - 1;
 
 					Ref<VoxelSurface> surface = _library->voxel_surface_get(type);
 
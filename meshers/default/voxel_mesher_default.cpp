@@ -53,6 +53,12 @@ void VoxelMesherDefault::_bake_colors(Ref<VoxelChunk> chunk) {
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 
+	//Bounds, and channels are only checked once, voxels are read with the unchecked accessor
+	bool has_channels = chunk->channel_get_count() > VoxelChunkDefault::DEFAULT_CHANNEL_RANDOM_AO;
+	unsigned int max_x = chunk->get_size_x() + chunk->get_margin_end();
+	unsigned int max_y = chunk->get_size_y() + chunk->get_margin_end();
+	unsigned int max_z = chunk->get_size_z() + chunk->get_margin_end();
+
 	for (int i = 0; i < _vertices.size(); ++i) {
 		Vertex vertex = _vertices[i];
 		Vector3 vert = vertex.vertex;
@@ -66,14 +72,14 @@ void VoxelMesherDefault::_bake_colors(Ref<VoxelChunk> chunk) {
 		unsigned int y = (unsigned int)(vert.y / _voxel_scale);
 		unsigned int z = (unsigned int)(vert.z / _voxel_scale);
 
-		if (chunk->validate_data_position(x, y, z)) {
+		if (has_channels && x < max_x && y < max_y && z < max_z) {
 			Color light = Color(
-					chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0,
-					chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0,
-					chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
+					chunk->get_voxel_unchecked(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0,
+					chunk->get_voxel_unchecked(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0,
+					chunk->get_voxel_unchecked(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
 
-			float ao = (chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO) / 255.0) * _ao_strength;
-			float rao = chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_RANDOM_AO) / 255.0;
+			float ao = (chunk->get_voxel_unchecked(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO) / 255.0) * _ao_strength;
+			float rao = chunk->get_voxel_unchecked(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_RANDOM_AO) / 255.0;
 
 			ao += rao;
 
@@ -112,6 +118,12 @@ void VoxelMesherDefault::_bake_liquid_colors(Ref<VoxelChunk> chunk) {
 
 	Color base_light(_base_light_value, _base_light_value, _base_light_value);
 
+	//Bounds, and channels are only checked once, voxels are read with the unchecked accessor
+	bool has_channels = chunk->channel_get_count() > VoxelChunkDefault::DEFAULT_CHANNEL_RANDOM_AO;
+	unsigned int max_x = chunk->get_size_x() + chunk->get_margin_end();
+	unsigned int max_y = chunk->get_size_y() + chunk->get_margin_end();
+	unsigned int max_z = chunk->get_size_z() + chunk->get_margin_end();
+
 	for (int i = 0; i < _vertices.size(); ++i) {
 		Vertex vertex = _vertices[i];
 		Vector3 vert = vertex.vertex;
@@ -125,14 +137,14 @@ void VoxelMesherDefault::_bake_liquid_colors(Ref<VoxelChunk> chunk) {
 		unsigned int y = (unsigned int)(vert.y / _voxel_scale);
 		unsigned int z = (unsigned int)(vert.z / _voxel_scale);
 
-		if (chunk->validate_data_position(x, y, z)) {
+		if (has_channels && x < max_x && y < max_y && z < max_z) {
 			Color light = Color(
-					chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0,
-					chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0,
-					chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
+					chunk->get_voxel_unchecked(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_R) / 255.0,
+					chunk->get_voxel_unchecked(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_G) / 255.0,
+					chunk->get_voxel_unchecked(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_LIGHT_COLOR_B) / 255.0);
 
-			float ao = (chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO) / 255.0) * _ao_strength;
-			float rao = chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_RANDOM_AO) / 255.0;
+			float ao = (chunk->get_voxel_unchecked(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO) / 255.0) * _ao_strength;
+			float rao = chunk->get_voxel_unchecked(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_RANDOM_AO) / 255.0;
 
 			ao += rao;
 
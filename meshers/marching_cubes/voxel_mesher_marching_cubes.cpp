@@ -48,7 +48,7 @@ typedef class RenderingServer VisualServer;
 #endif
 
 void VoxelMesherMarchingCubes::get_voxel_type_array(int *arr, Ref<VoxelChunk> chunk, const int x, const int y, const int z, const int size) {
-	uint8_t *channel_type = chunk->channel_get(_channel_index_type);
+	uint8_t *channel_type = chunk->channel_get_snapshot(_channel_index_type);
 
 	if (channel_type == NULL) {
 		arr[0] = 0;
@@ -70,6 +70,21 @@ void VoxelMesherMarchingCubes::get_voxel_type_array(int *arr, Ref<VoxelChunk> ch
 	arr[5] = channel_type[chunk->get_index(x + size, y + size, z)];
 	arr[6] = channel_type[chunk->get_index(x + size, y, z + size)];
 	arr[7] = channel_type[chunk->get_index(x + size, y + size, z + size)];
+
+	//Only set for 16 bit type channels that actually use the high bytes
+	uint8_t *channel_type_high = chunk->channel_get_high_snapshot(_channel_index_type);
+
+	if (!channel_type_high)
+		return;
+
+	arr[0] |= channel_type_high[chunk->get_index(x, y, z)] << 8;
+	arr[1] |= channel_type_high[chunk->get_index(x, y + size, z)] << 8;
+	arr[2] |= channel_type_high[chunk->get_index(x, y, z + size)] << 8;
+	arr[3] |= channel_type_high[chunk->get_index(x, y + size, z + size)] << 8;
+	arr[4] |= channel_type_high[chunk->get_index(x + size, y, z)] << 8;
+	arr[5] |= channel_type_high[chunk->get_index(x + size, y + size, z)] << 8;
+	arr[6] |= channel_type_high[chunk->get_index(x + size, y, z + size)] << 8;
+	arr[7] |= channel_type_high[chunk->get_index(x + size, y + size, z + size)] << 8;
 }
 int VoxelMesherMarchingCubes::get_case_code_from_arr(const int *data) {
 	int case_code = 0;
@@ -101,12 +116,21 @@ int VoxelMesherMarchingCubes::get_case_code_from_arr(const int *data) {
 	return case_code;
 }
 int VoxelMesherMarchingCubes::get_case_code(Ref<VoxelChunk> chunk, const int x, const int y, const int z, const int size) {
-	uint8_t *channel_type = chunk->channel_get(_channel_index_type);
+	uint8_t *channel_type = chunk->channel_get_snapshot(_channel_index_type);
 
 	if (channel_type == NULL) {
 		return 0;
 	}
 
+	//A type can have a zero low byte, so 16 bit channels go through the full decode.
+	//The check is done once per cube, the 8 bit path below is unchanged.
+	if (chunk->channel_get_high_snapshot(_channel_index_type)) {
+		int types[8];
+		get_voxel_type_array(types, chunk, x, y, z, size);
+
+		return get_case_code_from_arr(types);
+	}
+
 	int case_code = 0;
 
 	if (channel_type[chunk->get_index(x, y, z)] != 0)
@@ -137,12 +161,27 @@ int VoxelMesherMarchingCubes::get_case_code(Ref<VoxelChunk> chunk, const int x,
 }
 
 int VoxelMesherMarchingCubes::get_voxel_type(Ref<VoxelChunk> chunk, const int x, const int y, const int z, const int size) {
-	uint8_t *channel_type = chunk->channel_get(_channel_index_type);
+	uint8_t *channel_type = chunk->channel_get_snapshot(_channel_index_type);
 
 	if (channel_type == NULL) {
 		return 0;
 	}
 
+	if (chunk->channel_get_high_snapshot(_channel_index_type)) {
+		int types[8];
+		get_voxel_type_array(types, chunk, x, y, z, size);
+
+		//Same order as the 8 bit path below
+		static const int order[8] = { 1, 2, 3, 7, 0, 5, 4, 6 };
+
+		for (int i = 0; i < 8; ++i) {
+			if (types[order[i]] != 0)
+				return types[order[i]];
+		}
+
+		return 0;
+	}
+
 	int type = 0;
 
 	type = channel_type[chunk->get_index(x, y + size, z)];
@@ -200,6 +239,12 @@ void VoxelMesherMarchingCubes::_add_chunk(Ref<VoxelChunk> p_chunk) {
 	//job->remove_meta("ao_done");
 
 	if (job->should_return()) {
+		job->continuation_set_sub_pending(true);
+		return;
+	}
+
+	//Every cell would be either case 0 or 255
+	if (chunk->channel_is_uniform_snapshot(_channel_index_type)) {
 		return;
 	}
 
@@ -211,15 +256,12 @@ void VoxelMesherMarchingCubes::_add_chunk(Ref<VoxelChunk> p_chunk) {
 
 	int lod_size = 1;
 
-	int start_y = 0;
-
-	if (job->has_meta("mc_start_y")) {
-		start_y = job->get_meta("mc_start_y");
-	}
+	int start_y = job->continuation_get_sub_index();
 
 	for (int y = start_y; y < y_size; y += lod_size) {
 		if (job->should_return()) {
-			job->set_meta("mc_start_y", y);
+			job->continuation_set_sub_index(y);
+			job->continuation_set_sub_pending(true);
 			return;
 		}
 
@@ -325,7 +367,7 @@ void VoxelMesherMarchingCubes::_add_chunk(Ref<VoxelChunk> p_chunk) {
 					Vector3 offs0 = corner_id_to_vertex(fv) * lod_size;
 					Vector3 offs1 = corner_id_to_vertex(sv) * lod_size;
 
-					int type = chunk->get_voxel(int(x + offs0.x), int(y + offs0.y), int(z + offs0.z), _channel_index_type);
+					int type = chunk->get_voxel_snapshot(int(x + offs0.x), int(y + offs0.y), int(z + offs0.z), _channel_index_type);
 
 					int fill = 0;
 
@@ -333,12 +375,12 @@ void VoxelMesherMarchingCubes::_add_chunk(Ref<VoxelChunk> p_chunk) {
 					Vector3 vert_dir;
 
 					if (type == 0) {
-						fill = chunk->get_voxel(int(x + offs1.x), int(y + offs1.y), int(z + offs1.z), _channel_index_isolevel);
+						fill = chunk->get_voxel_snapshot(int(x + offs1.x), int(y + offs1.y), int(z + offs1.z), _channel_index_isolevel);
 
 						vert_pos = get_regular_vertex_second_position(case_code, i);
 						vert_dir = get_regular_vertex_first_position(case_code, i);
 					} else {
-						fill = chunk->get_voxel(int(x + offs0.x), int(y + offs0.y), int(z + offs0.z), _channel_index_isolevel);
+						fill = chunk->get_voxel_snapshot(int(x + offs0.x), int(y + offs0.y), int(z + offs0.z), _channel_index_isolevel);
 
 						vert_pos = get_regular_vertex_first_position(case_code, i);
 						vert_dir = get_regular_vertex_second_position(case_code, i);
@@ -462,21 +504,16 @@ void VoxelMesherMarchingCubes::_add_chunk(Ref<VoxelChunk> p_chunk) {
 		}
 	}
 
-	job->set_meta("mc_start_y", y_size);
+	job->continuation_set_sub_index(y_size);
 
 	if (job->should_return()) {
+		job->continuation_set_sub_pending(true);
 		return;
 	}
 
 	remove_doubles_hashed();
 
-	if (job->has_meta("mc_start_y")) {
-		job->remove_meta("mc_start_y");
-	}
-
-	if (job->has_meta("ao_done")) {
-		job->remove_meta("ao_done");
-	}
+	job->continuation_set_sub_index(0);
 }
 
 Vector3 VoxelMesherMarchingCubes::corner_id_to_vertex(int corner_id) const {
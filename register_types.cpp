@@ -41,6 +41,9 @@ SOFTWARE.
 
 #include "world/block_voxel_structure.h"
 #include "world/environment_data.h"
+#include "world/voxel_buffer_pool.h"
+#include "world/voxel_region_store.h"
+#include "world/voxel_world_pack.h"
 #include "world/voxel_chunk.h"
 #include "world/voxel_structure.h"
 #include "world/voxel_world.h"
@@ -73,6 +76,7 @@ SOFTWARE.
 #include "nodes/voxelman_light.h"
 
 #include "world/jobs/voxel_job.h"
+#include "world/jobs/voxel_job_scheduler.h"
 #include "world/jobs/voxel_light_job.h"
 #include "world/jobs/voxel_prop_job.h"
 #include "world/jobs/voxel_terrarin_job.h"
@@ -100,6 +104,9 @@ void register_voxelman_types() {
 
 	ClassDB::register_class<VoxelWorld>();
 	ClassDB::register_class<VoxelChunk>();
+	ClassDB::register_class<VoxelBufferPool>();
+	ClassDB::register_class<VoxelRegionStore>();
+	ClassDB::register_class<VoxelWorldPack>();
 	ClassDB::register_class<VoxelStructure>();
 	ClassDB::register_class<BlockVoxelStructure>();
 	ClassDB::register_class<EnvironmentData>();
@@ -134,7 +141,15 @@ void register_voxelman_types() {
 #ifdef TOOLS_ENABLED
 	EditorPlugins::add_by_type<VoxelWorldEditorPlugin>();
 #endif
+
+#if !THREAD_POOL_PRESENT
+	memnew(VoxelJobScheduler);
+#endif
 }
 
 void unregister_voxelman_types() {
+#if !THREAD_POOL_PRESENT
+	if (VoxelJobScheduler::get_singleton())
+		memdelete(VoxelJobScheduler::get_singleton());
+#endif
 }
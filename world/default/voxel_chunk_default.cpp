@@ -46,6 +46,8 @@ _FORCE_INLINE_ int VoxelChunkDefault::get_build_flags() const {
 }
 _FORCE_INLINE_ void VoxelChunkDefault::set_build_flags(const int flags) {
 	_build_flags = flags;
+
+	_channels_derived_update();
 }
 
 bool VoxelChunkDefault::get_lights_dirty() const {
@@ -878,6 +880,21 @@ VoxelChunkDefault::~VoxelChunkDefault() {
 
 void VoxelChunkDefault::_channel_setup() {
 	channel_set_count(MAX_DEFAULT_CHANNELS);
+
+	channel_set_derived(DEFAULT_CHANNEL_LIGHT_COLOR_R, true);
+	channel_set_derived(DEFAULT_CHANNEL_LIGHT_COLOR_G, true);
+	channel_set_derived(DEFAULT_CHANNEL_LIGHT_COLOR_B, true);
+
+	_channels_derived_update();
+}
+
+//AO is only calculated again during builds when it's generate flag is set, otherwise it's data that has to be saved
+void VoxelChunkDefault::_channels_derived_update() {
+	if (channel_get_count() < MAX_DEFAULT_CHANNELS)
+		return;
+
+	channel_set_derived(DEFAULT_CHANNEL_AO, (_build_flags & BUILD_FLAG_GENERATE_AO) != 0);
+	channel_set_derived(DEFAULT_CHANNEL_RANDOM_AO, (_build_flags & BUILD_FLAG_AUTO_GENERATE_RAO) != 0);
 }
 
 void VoxelChunkDefault::_bind_methods() {
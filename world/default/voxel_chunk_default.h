@@ -189,6 +189,7 @@ public:
 
 protected:
 	virtual void _channel_setup();
+	void _channels_derived_update();
 
 	virtual void _visibility_changed(bool visible);
 
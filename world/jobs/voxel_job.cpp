@@ -35,6 +35,9 @@ void VoxelJob::set_build_phase_type(VoxelJob::ActiveBuildPhaseType build_phase_t
 	_build_phase_type = build_phase_type;
 }
 
+Ref<VoxelChunk> VoxelJob::get_chunk() const {
+	return _chunk;
+}
 void VoxelJob::set_chunk(const Ref<VoxelChunk> &chunk) {
 	_chunk = chunk;
 
@@ -63,12 +66,37 @@ void VoxelJob::next_job() {
 	set_build_done(true);
 }
 
+int VoxelJob::continuation_get_slot(const int index) const {
+	ERR_FAIL_INDEX_V(index, CONTINUATION_SLOT_COUNT, 0);
+
+	return _continuation.phase == _phase ? _continuation.slots[index] : 0;
+}
+void VoxelJob::continuation_set_slot(const int index, const int value) {
+	ERR_FAIL_INDEX(index, CONTINUATION_SLOT_COUNT);
+
+	_continuation_ensure();
+	_continuation.slots[index] = value;
+}
+
+void VoxelJob::continuation_clear() {
+	_continuation.phase = -1;
+	_continuation.mesher_index = 0;
+	_continuation.sub_index = 0;
+	_continuation.sub_pending = false;
+
+	for (int i = 0; i < CONTINUATION_SLOT_COUNT; ++i) {
+		_continuation.slots[i] = 0;
+	}
+}
+
 void VoxelJob::reset() {
 	call("_reset");
 }
 void VoxelJob::_reset() {
 	_build_done = false;
 	_phase = 0;
+
+	continuation_clear();
 }
 
 void VoxelJob::_execute() {
@@ -114,6 +142,12 @@ void VoxelJob::generate_ao() {
 	int margin_start = _chunk->get_margin_start();
 	int margin_end = _chunk->get_margin_end();
 
+	//A uniform isolevel channel can't produce any occlusion
+	if (_chunk->channel_is_uniform_snapshot(VoxelChunkDefault::DEFAULT_CHANNEL_ISOLEVEL)) {
+		_chunk->channel_fill(0, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
+		return;
+	}
+
 	int ssize_x = _chunk->get_size_x();
 	int ssize_y = _chunk->get_size_y();
 	int ssize_z = _chunk->get_size_z();
@@ -122,17 +156,51 @@ void VoxelJob::generate_ao() {
 	int size_y = ssize_y + margin_end;
 	int size_z = ssize_z + margin_end;
 
-	for (int y = margin_start - 1; y < size_y - 1; ++y) {
-		for (int z = margin_start - 1; z < size_z - 1; ++z) {
-			for (int x = margin_start - 1; x < size_x - 1; ++x) {
-				int current = _chunk->get_voxel(x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_ISOLEVEL);
+	//Every voxel needs all of it's neighbours to be inside the data
+	int start = MAX(margin_start - 1, 1 - margin_start);
+
+	int ao_size_x = size_x - 1 - start;
+	int ao_size_y = size_y - 1 - start;
+	int ao_size_z = size_z - 1 - start;
+
+	if (ao_size_x <= 0 || ao_size_y <= 0 || ao_size_z <= 0)
+		return;
+
+	int iso_size_x = ao_size_x + 2;
+	int iso_size_y = ao_size_y + 2;
+	int iso_size_z = ao_size_z + 2;
+
+	Vector<int> channels;
+	channels.push_back(VoxelChunkDefault::DEFAULT_CHANNEL_ISOLEVEL);
+
+	Vector<uint8_t> isolevels;
+	isolevels.resize(iso_size_x * iso_size_y * iso_size_z);
+
+	if (!_chunk->copy_region_to(isolevels.ptrw(), AABB(Vector3(start - 1, start - 1, start - 1), Vector3(iso_size_x, iso_size_y, iso_size_z)), channels, true))
+		return;
+
+	Vector<uint8_t> aos;
+	aos.resize(ao_size_x * ao_size_y * ao_size_z);
+
+	const uint8_t *iso = isolevels.ptr();
+	uint8_t *ao = aos.ptrw();
+
+	int stride_x = iso_size_y;
+	int stride_z = iso_size_y * iso_size_x;
+
+	for (int z = 0; z < ao_size_z; ++z) {
+		for (int x = 0; x < ao_size_x; ++x) {
+			for (int y = 0; y < ao_size_y; ++y) {
+				int index = (y + 1) + stride_x * (x + 1) + stride_z * (z + 1);
 
-				int sum = _chunk->get_voxel(x + 1, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_ISOLEVEL);
-				sum += _chunk->get_voxel(x - 1, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_ISOLEVEL);
-				sum += _chunk->get_voxel(x, y + 1, z, VoxelChunkDefault::DEFAULT_CHANNEL_ISOLEVEL);
-				sum += _chunk->get_voxel(x, y - 1, z, VoxelChunkDefault::DEFAULT_CHANNEL_ISOLEVEL);
-				sum += _chunk->get_voxel(x, y, z + 1, VoxelChunkDefault::DEFAULT_CHANNEL_ISOLEVEL);
-				sum += _chunk->get_voxel(x, y, z - 1, VoxelChunkDefault::DEFAULT_CHANNEL_ISOLEVEL);
+				int current = iso[index];
+
+				int sum = iso[index + stride_x];
+				sum += iso[index - stride_x];
+				sum += iso[index + 1];
+				sum += iso[index - 1];
+				sum += iso[index + stride_z];
+				sum += iso[index - stride_z];
 
 				sum /= 6;
 
@@ -141,10 +209,14 @@ void VoxelJob::generate_ao() {
 				if (sum < 0)
 					sum = 0;
 
-				_chunk->set_voxel(sum, x, y, z, VoxelChunkDefault::DEFAULT_CHANNEL_AO);
+				ao[y + ao_size_y * (x + ao_size_x * z)] = sum;
 			}
 		}
 	}
+
+	channels.write[0] = VoxelChunkDefault::DEFAULT_CHANNEL_AO;
+
+	_chunk->write_region_from(ao, AABB(Vector3(start, start, start), Vector3(ao_size_x, ao_size_y, ao_size_z)), channels);
 }
 
 void VoxelJob::generate_random_ao(int seed, int octaves, int period, float persistence, float scale_factor) {
@@ -311,12 +383,15 @@ VoxelJob::VoxelJob() {
 	_build_done = true;
 	_phase = 0;
 
+	continuation_clear();
+
 #if !THREAD_POOL_PRESENT
 	_complete = true;
 	_cancelled = false;
 
 	_max_allocated_time = 0;
 	_start_time = 0;
+	_deadline = 0;
 
 	_current_run_stage = 0;
 	_stage = 0;
@@ -335,6 +410,7 @@ void VoxelJob::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_build_phase_type", "value"), &VoxelJob::set_build_phase_type);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "build_phase_type", PROPERTY_HINT_ENUM, BINDING_STRING_ACTIVE_BUILD_PHASE_TYPE), "set_build_phase_type", "get_build_phase_type");
 
+	ClassDB::bind_method(D_METHOD("get_chunk"), &VoxelJob::get_chunk);
 	ClassDB::bind_method(D_METHOD("set_chunk", "chunk"), &VoxelJob::set_chunk);
 
 	ClassDB::bind_method(D_METHOD("get_phase"), &VoxelJob::get_phase);
@@ -346,6 +422,18 @@ void VoxelJob::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("next_job"), &VoxelJob::next_job);
 
+	ClassDB::bind_method(D_METHOD("continuation_get_mesher_index"), &VoxelJob::continuation_get_mesher_index);
+	ClassDB::bind_method(D_METHOD("continuation_set_mesher_index", "value"), &VoxelJob::continuation_set_mesher_index);
+	ClassDB::bind_method(D_METHOD("continuation_get_sub_index"), &VoxelJob::continuation_get_sub_index);
+	ClassDB::bind_method(D_METHOD("continuation_set_sub_index", "value"), &VoxelJob::continuation_set_sub_index);
+	ClassDB::bind_method(D_METHOD("continuation_get_sub_pending"), &VoxelJob::continuation_get_sub_pending);
+	ClassDB::bind_method(D_METHOD("continuation_set_sub_pending", "value"), &VoxelJob::continuation_set_sub_pending);
+	ClassDB::bind_method(D_METHOD("continuation_get_slot", "index"), &VoxelJob::continuation_get_slot);
+	ClassDB::bind_method(D_METHOD("continuation_set_slot", "index", "value"), &VoxelJob::continuation_set_slot);
+	ClassDB::bind_method(D_METHOD("continuation_clear"), &VoxelJob::continuation_clear);
+
+	BIND_CONSTANT(CONTINUATION_SLOT_COUNT);
+
 	BIND_VMETHOD(MethodInfo("_reset"));
 
 	ClassDB::bind_method(D_METHOD("reset"), &VoxelJob::reset);
@@ -368,6 +456,10 @@ void VoxelJob::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_complete", "value"), &VoxelJob::set_complete);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "complete"), "set_complete", "get_complete");
 
+	ClassDB::bind_method(D_METHOD("get_max_allocated_time"), &VoxelJob::get_max_allocated_time);
+	ClassDB::bind_method(D_METHOD("set_max_allocated_time", "value"), &VoxelJob::set_max_allocated_time);
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "max_allocated_time"), "set_max_allocated_time", "get_max_allocated_time");
+
 	ClassDB::bind_method(D_METHOD("get_start_time"), &VoxelJob::get_start_time);
 	ClassDB::bind_method(D_METHOD("set_start_time", "value"), &VoxelJob::set_start_time);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "start_time"), "set_start_time", "get_start_time");
@@ -384,6 +476,7 @@ void VoxelJob::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("should_do", "just_check"), &VoxelJob::should_do, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("should_return"), &VoxelJob::should_return);
+	ClassDB::bind_method(D_METHOD("should_continue"), &VoxelJob::should_continue);
 
 	BIND_VMETHOD(MethodInfo("_execute"));
 	ClassDB::bind_method(D_METHOD("execute"), &VoxelJob::execute);
@@ -441,22 +534,55 @@ void VoxelJob::reset_stages() {
 }
 
 float VoxelJob::get_current_execution_time() {
-	return 0;
+	return (OS::get_singleton()->get_ticks_usec() - _start_time) / 1000000.0;
 }
 
 bool VoxelJob::should_do(const bool just_check) {
+	//Already done in a previous slice
+	if (_current_run_stage < _stage) {
+		if (!just_check)
+			++_current_run_stage;
+
+		return false;
+	}
+
+	if (!just_check) {
+		++_current_run_stage;
+		++_stage;
+	}
+
 	return true;
 }
 bool VoxelJob::should_return() {
 	if (_cancelled)
 		return true;
 
+	if (_max_allocated_time > 0 && get_current_execution_time() >= _max_allocated_time)
+		return true;
+
+	if (_deadline != 0 && OS::get_singleton()->get_ticks_usec() >= _deadline)
+		return true;
+
 	return false;
 }
 
+uint64_t VoxelJob::get_deadline() const {
+	return _deadline;
+}
+void VoxelJob::set_deadline(const uint64_t value) {
+	_deadline = value;
+}
+
+bool VoxelJob::should_continue() const {
+	return !_cancelled && _in_tree && !_build_done && _build_phase_type == BUILD_PHASE_TYPE_NORMAL;
+}
+
 void VoxelJob::execute() {
 	ERR_FAIL_COND(!has_method("_execute"));
 
+	_current_run_stage = 0;
+	_start_time = OS::get_singleton()->get_ticks_usec();
+
 	call("_execute");
 }
 
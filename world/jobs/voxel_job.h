@@ -64,10 +64,15 @@ public:
 		BUILD_PHASE_TYPE_PHYSICS_PROCESS,
 	};
 
+	enum {
+		CONTINUATION_SLOT_COUNT = 4,
+	};
+
 public:
 	ActiveBuildPhaseType get_build_phase_type();
 	void set_build_phase_type(VoxelJob::ActiveBuildPhaseType build_phase_type);
 
+	Ref<VoxelChunk> get_chunk() const;
 	void set_chunk(const Ref<VoxelChunk> &chunk);
 
 	int get_phase();
@@ -79,6 +84,39 @@ public:
 
 	void next_job();
 
+	//Where the current phase stopped when it returned early, so it can continue from there when it's executed again.
+	//The mesher index is the mesher the job was at, the sub index is the progress inside of that mesher.
+	//The state belongs to the phase that saved it, in every other phase it reads as 0.
+	_FORCE_INLINE_ int continuation_get_mesher_index() const {
+		return _continuation.phase == _phase ? _continuation.mesher_index : 0;
+	}
+	_FORCE_INLINE_ void continuation_set_mesher_index(const int value) {
+		_continuation_ensure();
+		_continuation.mesher_index = value;
+	}
+
+	_FORCE_INLINE_ int continuation_get_sub_index() const {
+		return _continuation.phase == _phase ? _continuation.sub_index : 0;
+	}
+	_FORCE_INLINE_ void continuation_set_sub_index(const int value) {
+		_continuation_ensure();
+		_continuation.sub_index = value;
+	}
+
+	//Set by a mesher that returns before it's done, so the job calls it again instead of moving on to the next one
+	_FORCE_INLINE_ bool continuation_get_sub_pending() const {
+		return _continuation.phase == _phase && _continuation.sub_pending;
+	}
+	_FORCE_INLINE_ void continuation_set_sub_pending(const bool value) {
+		_continuation_ensure();
+		_continuation.sub_pending = value;
+	}
+
+	int continuation_get_slot(const int index) const;
+	void continuation_set_slot(const int index, const int value);
+
+	void continuation_clear();
+
 	void reset();
 	virtual void _reset();
 
@@ -103,6 +141,23 @@ public:
 protected:
 	static void _bind_methods();
 
+	struct ContinuationState {
+		int phase;
+		int mesher_index;
+		int sub_index;
+		bool sub_pending;
+		int slots[CONTINUATION_SLOT_COUNT];
+	};
+
+	_FORCE_INLINE_ void _continuation_ensure() {
+		if (_continuation.phase != _phase) {
+			continuation_clear();
+			_continuation.phase = _phase;
+		}
+	}
+
+	ContinuationState _continuation;
+
 	ActiveBuildPhaseType _build_phase_type;
 	bool _build_done;
 	int _phase;
@@ -133,9 +188,19 @@ public:
 
 	float get_current_execution_time();
 
+	//Stages let a phase skip the parts it already finished when it's resumed
 	bool should_do(const bool just_check = false);
+	//True when the job ran out of max_allocated_time, or went past the deadline
 	bool should_return();
 
+	//In OS::get_ticks_usec() time, 0 means none. Used to share a frame's budget between jobs.
+	uint64_t get_deadline() const;
+	void set_deadline(const uint64_t value);
+
+	//True if the last execute() returned because of the time limits, and the job needs to be executed again
+	bool should_continue() const;
+
+	//Every call is a new slice, the execution time starts from 0
 	void execute();
 
 private:
@@ -144,6 +209,7 @@ private:
 
 	float _max_allocated_time;
 	uint64_t _start_time;
+	uint64_t _deadline;
 
 	int _current_run_stage;
 	int _stage;
@@ -0,0 +1,263 @@
+/*
+Copyright (c) 2019-2020 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "voxel_job_scheduler.h"
+
+#include "core/os/os.h"
+
+#include <thread>
+
+#if VERSION_MAJOR > 3
+#include "core/config/project_settings.h"
+#else
+#include "core/project_settings.h"
+#endif
+
+#if defined(__linux__)
+#include <sched.h>
+#elif defined(WINDOWS_ENABLED)
+#include <windows.h>
+#endif
+
+#if !THREAD_POOL_PRESENT
+
+VoxelJobScheduler *VoxelJobScheduler::_singleton = NULL;
+
+//-1 on threads that are not workers
+static thread_local int _current_worker = -1;
+
+VoxelJobScheduler *VoxelJobScheduler::get_singleton() {
+	return _singleton;
+}
+
+int VoxelJobScheduler::get_thread_count() const {
+	return _thread_count;
+}
+bool VoxelJobScheduler::get_thread_affinity() const {
+	return _thread_affinity;
+}
+
+void VoxelJobScheduler::add_job(const Ref<VoxelJob> &job) {
+	ERR_FAIL_COND(!job.is_valid());
+
+	if (_thread_count == 0) {
+		job->execute();
+		return;
+	}
+
+	if (!_started)
+		_start();
+
+	Worker *worker;
+
+	if (_current_worker != -1) {
+		worker = _workers[_current_worker];
+	} else {
+		_mutex.lock();
+		worker = _workers[_next_worker++ % _workers.size()];
+		_mutex.unlock();
+	}
+
+	worker->mutex.lock();
+	worker->jobs.push_back(job);
+	worker->mutex.unlock();
+
+	_semaphore.post();
+}
+
+VoxelJobScheduler::VoxelJobScheduler() {
+	_singleton = this;
+
+	_started = false;
+	_next_worker = 0;
+
+	_thread_count = GLOBAL_DEF("voxelman/job_scheduler/thread_count", -1);
+	_thread_affinity = GLOBAL_DEF("voxelman/job_scheduler/thread_affinity", false);
+
+	//The main thread is busy enough
+	if (_thread_count < 0)
+		_thread_count = OS::get_singleton()->get_processor_count() - 1;
+
+	if (!OS::get_singleton()->can_use_threads())
+		_thread_count = 0;
+}
+
+VoxelJobScheduler::~VoxelJobScheduler() {
+	_stop();
+
+	if (_singleton == this)
+		_singleton = NULL;
+}
+
+void VoxelJobScheduler::_start() {
+	_mutex.lock();
+
+	//Another thread might have started them in the meantime
+	if (!_started) {
+		_exit.clear();
+
+		for (int i = 0; i < _thread_count; ++i) {
+			Worker *worker = memnew(Worker);
+			worker->scheduler = this;
+			worker->index = i;
+
+			_workers.push_back(worker);
+		}
+
+		//Only after every queue exists, workers steal from each other
+		for (int i = 0; i < _workers.size(); ++i) {
+			_workers[i]->thread.start(_worker_func, _workers[i]);
+		}
+
+		_started = true;
+	}
+
+	_mutex.unlock();
+}
+
+void VoxelJobScheduler::_stop() {
+	if (!_started)
+		return;
+
+	_exit.set();
+
+	for (int i = 0; i < _workers.size(); ++i) {
+		_semaphore.post();
+	}
+
+	for (int i = 0; i < _workers.size(); ++i) {
+		_workers[i]->thread.wait_to_finish();
+	}
+
+	for (int i = 0; i < _workers.size(); ++i) {
+		memdelete(_workers[i]);
+	}
+
+	_workers.clear();
+	_started = false;
+}
+
+bool VoxelJobScheduler::_pop(Worker *worker, Ref<VoxelJob> &r_job) {
+	worker->mutex.lock();
+
+	bool found = worker->jobs.size() > 0;
+
+	//Newest first, its chunk's data is likely still in the cache
+	if (found) {
+		r_job = worker->jobs.back()->get();
+		worker->jobs.pop_back();
+	} else if (worker->yielded.size() > 0) {
+		r_job = worker->yielded.front()->get();
+		worker->yielded.pop_front();
+		found = true;
+	}
+
+	worker->mutex.unlock();
+
+	return found;
+}
+
+bool VoxelJobScheduler::_steal(Worker *thief, Ref<VoxelJob> &r_job) {
+	for (int i = 1; i < _workers.size(); ++i) {
+		Worker *victim = _workers[(thief->index + i) % _workers.size()];
+
+		victim->mutex.lock();
+
+		bool found = victim->jobs.size() > 0;
+
+		//Oldest first, the victim is working on the newer ones
+		if (found) {
+			r_job = victim->jobs.front()->get();
+			victim->jobs.pop_front();
+		} else if (victim->yielded.size() > 0) {
+			r_job = victim->yielded.front()->get();
+			victim->yielded.pop_front();
+			found = true;
+		}
+
+		victim->mutex.unlock();
+
+		if (found)
+			return true;
+	}
+
+	return false;
+}
+
+void VoxelJobScheduler::_worker_func(void *p_userdata) {
+	Worker *worker = reinterpret_cast<Worker *>(p_userdata);
+	VoxelJobScheduler *scheduler = worker->scheduler;
+
+	_current_worker = worker->index;
+
+	//Core 0 is left to the main thread
+	if (scheduler->_thread_affinity)
+		_set_affinity(worker->index + 1);
+
+	while (true) {
+		scheduler->_semaphore.wait();
+
+		if (scheduler->_exit.is_set())
+			break;
+
+		//There is a job in one of the queues for every post, but the queues are checked one by one, other workers can
+		//take jobs ahead of the scan while new ones get added behind it. Another pass finds them, the time slice is given up in between.
+		Ref<VoxelJob> job;
+
+		while (!scheduler->_pop(worker, job) && !scheduler->_steal(worker, job)) {
+			if (scheduler->_exit.is_set())
+				return;
+
+			std::this_thread::yield();
+		}
+
+		job->execute();
+
+		//Ran out of it's max_allocated_time, it continues after this worker's other jobs (or on an idle worker)
+		if (job->should_continue()) {
+			worker->mutex.lock();
+			worker->yielded.push_back(job);
+			worker->mutex.unlock();
+
+			scheduler->_semaphore.post();
+		}
+	}
+}
+
+void VoxelJobScheduler::_set_affinity(const int core) {
+	int count = OS::get_singleton()->get_processor_count();
+
+	if (count <= 1)
+		return;
+
+#if defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(core % count, &set);
+
+	sched_setaffinity(0, sizeof(cpu_set_t), &set);
+#elif defined(WINDOWS_ENABLED)
+	SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << (core % count));
+#endif
+}
+
+#endif
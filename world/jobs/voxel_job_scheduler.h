@@ -0,0 +1,100 @@
+/*
+Copyright (c) 2019-2020 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef VOXEL_JOB_SCHEDULER_H
+#define VOXEL_JOB_SCHEDULER_H
+
+#include "core/version.h"
+
+#if VERSION_MAJOR > 3
+#include "core/templates/list.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/vector.h"
+#else
+#include "core/list.h"
+#include "core/safe_refcount.h"
+#include "core/vector.h"
+#endif
+
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+
+#include "voxel_job.h"
+
+#if !THREAD_POOL_PRESENT
+
+//Runs VoxelJobs on worker threads when the thread_pool module is not present.
+//Every worker has its own queue, jobs added by a worker (the next job of a chunk) go to its own queue,
+//the rest are distributed between them. Idle workers steal the oldest jobs from the others.
+//Jobs that ran out of their max_allocated_time wait in a separate queue, until the rest of the worker's jobs are done.
+//Configured with the voxelman/job_scheduler/thread_count (-1 means processor count - 1),
+//and voxelman/job_scheduler/thread_affinity project settings. Threads are only started when the first job is added.
+class VoxelJobScheduler {
+public:
+	static VoxelJobScheduler *get_singleton();
+
+	//0 if jobs should be executed synchronously
+	int get_thread_count() const;
+	bool get_thread_affinity() const;
+
+	void add_job(const Ref<VoxelJob> &job);
+
+	VoxelJobScheduler();
+	~VoxelJobScheduler();
+
+protected:
+	struct Worker {
+		VoxelJobScheduler *scheduler;
+		int index;
+		Thread thread;
+		Mutex mutex;
+		List<Ref<VoxelJob> > jobs;
+		List<Ref<VoxelJob> > yielded;
+	};
+
+	void _start();
+	void _stop();
+
+	bool _pop(Worker *worker, Ref<VoxelJob> &r_job);
+	bool _steal(Worker *thief, Ref<VoxelJob> &r_job);
+
+	static void _worker_func(void *p_userdata);
+	static void _set_affinity(const int core);
+
+	static VoxelJobScheduler *_singleton;
+
+	int _thread_count;
+	bool _thread_affinity;
+
+	Vector<Worker *> _workers;
+	//Posted once for every added job
+	Semaphore _semaphore;
+	Mutex _mutex;
+	bool _started;
+	SafeFlag _exit;
+	uint32_t _next_worker;
+};
+
+#endif
+
+#endif
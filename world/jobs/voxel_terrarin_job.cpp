@@ -100,16 +100,21 @@ void VoxelTerrarinJob::phase_setup() {
 	next_phase();
 }
 
-void VoxelTerrarinJob::phase_terrarin_mesh_setup() {
-	int starti = 0;
-
-	if (has_meta("tms_m")) {
-		starti = get_meta("tms_m");
+int VoxelTerrarinJob::_get_merge_target(const Vector<Ref<VoxelMesher>> &meshers) {
+	for (int i = 0; i < meshers.size(); ++i) {
+		if (meshers[i].is_valid())
+			return i;
 	}
 
+	return -1;
+}
+
+void VoxelTerrarinJob::phase_terrarin_mesh_setup() {
+	int starti = continuation_get_mesher_index();
+
 	for (int i = starti; i < _meshers.size(); ++i) {
 		if (should_return()) {
-			set_meta("tms_m", i);
+			continuation_set_mesher_index(i);
 			return;
 		}
 
@@ -117,18 +122,28 @@ void VoxelTerrarinJob::phase_terrarin_mesh_setup() {
 
 		ERR_CONTINUE(!mesher.is_valid());
 
+		continuation_set_sub_pending(false);
+
 		mesher->add_chunk(_chunk);
-	}
 
-	starti = 0;
+		//It returned before it was done, it continues from it's sub index
+		if (continuation_get_sub_pending()) {
+			continuation_set_mesher_index(i);
+			return;
+		}
 
-	if (has_meta("tms_lm")) {
-		starti = get_meta("tms_lm");
+		//The next mesher starts from the beginning
+		continuation_set_sub_index(0);
 	}
 
+	//So they are not added again if a liquid mesher returns early
+	continuation_set_mesher_index(_meshers.size());
+
+	starti = continuation_get_slot(CONTINUATION_SLOT_LIQUID_MESHER);
+
 	for (int i = starti; i < _liquid_meshers.size(); ++i) {
 		if (should_return()) {
-			set_meta("tms_lm", i);
+			continuation_set_slot(CONTINUATION_SLOT_LIQUID_MESHER, i);
 			return;
 		}
 
@@ -136,17 +151,20 @@ void VoxelTerrarinJob::phase_terrarin_mesh_setup() {
 
 		ERR_CONTINUE(!mesher.is_valid());
 
+		continuation_set_sub_pending(false);
+
 		mesher->add_chunk(_chunk);
-	}
 
-	if (has_meta("tms_m")) {
-		remove_meta("tms_m");
-	}
+		if (continuation_get_sub_pending()) {
+			continuation_set_slot(CONTINUATION_SLOT_LIQUID_MESHER, i);
+			return;
+		}
 
-	if (has_meta("tms_lm")) {
-		remove_meta("tms_lm");
+		continuation_set_sub_index(0);
 	}
 
+	continuation_clear();
+
 	next_phase();
 }
 
@@ -158,15 +176,11 @@ void VoxelTerrarinJob::phase_collider() {
 		return;
 	}
 
-	int starti = 0;
-
-	if (has_meta("bpc_aa")) {
-		starti = get_meta("bpc_aa");
-	}
+	int starti = continuation_get_mesher_index();
 
 	for (int i = starti; i < _meshers.size(); ++i) {
 		if (should_return()) {
-			set_meta("bpc_aa", i);
+			continuation_set_mesher_index(i);
 			return;
 		}
 
@@ -177,16 +191,15 @@ void VoxelTerrarinJob::phase_collider() {
 		temp_arr_collider.append_array(mesher->build_collider());
 	}
 
-	if (Engine::get_singleton()->is_editor_hint()) {
-		starti = 0;
+	//Their colliders would be appended again if a liquid mesher returns early
+	continuation_set_mesher_index(_meshers.size());
 
-		if (has_meta("bpc_laa")) {
-			starti = get_meta("bpc_laa");
-		}
+	if (Engine::get_singleton()->is_editor_hint()) {
+		starti = continuation_get_slot(CONTINUATION_SLOT_LIQUID_MESHER);
 
-		for (int i = 0; i < _liquid_meshers.size(); ++i) {
+		for (int i = starti; i < _liquid_meshers.size(); ++i) {
 			if (should_return()) {
-				set_meta("bpc_laa", i);
+				continuation_set_slot(CONTINUATION_SLOT_LIQUID_MESHER, i);
 				return;
 			}
 
@@ -198,13 +211,7 @@ void VoxelTerrarinJob::phase_collider() {
 		}
 	}
 
-	if (has_meta("bpc_aa")) {
-		remove_meta("bpc_aa");
-	}
-
-	if (has_meta("bpc_laa")) {
-		remove_meta("bpc_laa");
-	}
+	continuation_clear();
 
 	if (temp_arr_collider.size() == 0 && temp_arr_collider_liquid.size() == 0) {
 		next_phase();
@@ -255,15 +262,12 @@ void VoxelTerrarinJob::phase_terrarin_mesh() {
 	Ref<VoxelChunkDefault> chunk = _chunk;
 
 	if ((chunk->get_build_flags() & VoxelChunkDefault::BUILD_FLAG_USE_LIGHTING) != 0) {
-		int starti = 0;
-
-		if (has_meta("bptm_ulm")) {
-			starti = get_meta("bptm_ulm");
-		}
+		int starti = continuation_get_mesher_index();
 
 		for (int i = starti; i < _meshers.size(); ++i) {
 			if (should_return()) {
-				set_meta("bptm_ulm", i);
+				continuation_set_mesher_index(i);
+				return;
 			}
 
 			Ref<VoxelMesher> mesher = _meshers.get(i);
@@ -273,15 +277,14 @@ void VoxelTerrarinJob::phase_terrarin_mesh() {
 			mesher->bake_colors(_chunk);
 		}
 
-		starti = 0;
+		continuation_set_mesher_index(_meshers.size());
 
-		if (has_meta("bptm_ullm")) {
-			starti = get_meta("bptm_ullm");
-		}
+		starti = continuation_get_slot(CONTINUATION_SLOT_LIQUID_MESHER);
 
 		for (int i = starti; i < _liquid_meshers.size(); ++i) {
 			if (should_return()) {
-				set_meta("bptm_ullm", i);
+				continuation_set_slot(CONTINUATION_SLOT_LIQUID_MESHER, i);
+				return;
 			}
 
 			Ref<VoxelMesher> mesher = _liquid_meshers.get(i);
@@ -290,78 +293,62 @@ void VoxelTerrarinJob::phase_terrarin_mesh() {
 
 			mesher->bake_colors(_chunk);
 		}
+
+		continuation_set_slot(CONTINUATION_SLOT_LIQUID_MESHER, _liquid_meshers.size());
 	}
 
-	int starti = 0;
+	//The first valid mesher is the merge target, so it's the same one when the merge continues in a later slice
+	int target = _get_merge_target(_meshers);
 
-	if (has_meta("bptm_mm")) {
-		starti = get_meta("bptm_mm");
-	}
+	ERR_FAIL_COND(target == -1);
+
+	Ref<VoxelMesher> mesher = _meshers.get(target);
+	mesher->set_material(_chunk->get_library()->material_get(0));
+
+	int starti = MAX(continuation_get_slot(CONTINUATION_SLOT_MERGE_MESHER), target + 1);
 
-	Ref<VoxelMesher> mesher;
 	for (int i = starti; i < _meshers.size(); ++i) {
 		if (should_return()) {
-			set_meta("bptm_mm", i);
+			continuation_set_slot(CONTINUATION_SLOT_MERGE_MESHER, i);
+			return;
 		}
 
 		Ref<VoxelMesher> m = _meshers.get(i);
 
 		ERR_CONTINUE(!m.is_valid());
 
-		if (!mesher.is_valid()) {
-			mesher = m;
-			mesher->set_material(_chunk->get_library()->material_get(0));
-			continue;
-		}
-
-		mesher->set_material(_chunk->get_library()->material_get(0));
 		mesher->add_mesher(m);
 	}
 
-	ERR_FAIL_COND(!mesher.is_valid());
-
-	starti = 0;
-
-	if (has_meta("bptm_lmm")) {
-		starti = get_meta("bptm_lmm");
-	}
+	continuation_set_slot(CONTINUATION_SLOT_MERGE_MESHER, _meshers.size());
 
 	Ref<VoxelMesher> liquid_mesher;
-	for (int i = starti; i < _liquid_meshers.size(); ++i) {
-		if (should_return()) {
-			set_meta("bptm_lmm", i);
-		}
+	target = _get_merge_target(_liquid_meshers);
 
-		Ref<VoxelMesher> m = _liquid_meshers.get(i);
+	if (target != -1) {
+		liquid_mesher = _liquid_meshers.get(target);
+		liquid_mesher->set_material(_chunk->get_library()->material_get(0));
 
-		ERR_CONTINUE(!m.is_valid());
+		starti = MAX(continuation_get_slot(CONTINUATION_SLOT_MERGE_LIQUID_MESHER), target + 1);
 
-		if (!liquid_mesher.is_valid()) {
-			liquid_mesher = m;
-			liquid_mesher->set_material(_chunk->get_library()->material_get(0));
-			continue;
-		}
+		for (int i = starti; i < _liquid_meshers.size(); ++i) {
+			if (should_return()) {
+				continuation_set_slot(CONTINUATION_SLOT_MERGE_LIQUID_MESHER, i);
+				return;
+			}
 
-		liquid_mesher->set_material(_chunk->get_library()->material_get(0));
-		liquid_mesher->add_mesher(m);
-	}
+			Ref<VoxelMesher> m = _liquid_meshers.get(i);
 
-	if (mesher->get_vertex_count() == 0 && liquid_mesher.is_valid() && liquid_mesher->get_vertex_count() == 0) {
-		if (has_meta("bptm_ulm")) {
-			remove_meta("bptm_ulm");
-		}
+			ERR_CONTINUE(!m.is_valid());
 
-		if (has_meta("bptm_ullm")) {
-			remove_meta("bptm_ullm");
+			liquid_mesher->add_mesher(m);
 		}
 
-		if (has_meta("bptm_mm")) {
-			remove_meta("bptm_mm");
-		}
+		continuation_set_slot(CONTINUATION_SLOT_MERGE_LIQUID_MESHER, _liquid_meshers.size());
+	}
 
-		if (has_meta("bptm_lmm")) {
-			remove_meta("bptm_lmm");
-		}
+	if (mesher->get_vertex_count() == 0 && liquid_mesher.is_valid() && liquid_mesher->get_vertex_count() == 0) {
+		continuation_clear();
 
 		reset_stages();
 		next_phase();
@@ -550,21 +537,7 @@ void VoxelTerrarinJob::phase_terrarin_mesh() {
 		//}
 	}
 
-	if (has_meta("bptm_ulm")) {
-		remove_meta("bptm_ulm");
-	}
-
-	if (has_meta("bptm_ullm")) {
-		remove_meta("bptm_ullm");
-	}
-
-	if (has_meta("bptm_mm")) {
-		remove_meta("bptm_mm");
-	}
-
-	if (has_meta("bptm_lmm")) {
-		remove_meta("bptm_lmm");
-	}
+	continuation_clear();
 
 	reset_stages();
 	next_phase();
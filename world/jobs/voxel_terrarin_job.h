@@ -69,6 +69,16 @@ public:
 protected:
 	static void _bind_methods();
 
+	//The mesher loops use the mesher index, these are for the rest
+	enum {
+		CONTINUATION_SLOT_LIQUID_MESHER = 0,
+		CONTINUATION_SLOT_MERGE_MESHER,
+		CONTINUATION_SLOT_MERGE_LIQUID_MESHER,
+	};
+
+	//Index of the first valid mesher, -1 if there is none
+	static int _get_merge_target(const Vector<Ref<VoxelMesher>> &meshers);
+
 	Vector<Ref<VoxelMesher>> _meshers;
 	Vector<Ref<VoxelMesher>> _liquid_meshers;
 
@@ -0,0 +1,167 @@
+/*
+Copyright (c) 2019-2020 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "voxel_buffer_pool.h"
+
+//Buffers are not necessarily aligned for a pointer
+_FORCE_INLINE_ static uint8_t *free_list_next(const uint8_t *buffer) {
+	uint8_t *next;
+	memcpy(&next, buffer, sizeof(uint8_t *));
+	return next;
+}
+_FORCE_INLINE_ static void free_list_set_next(uint8_t *buffer, uint8_t *next) {
+	memcpy(buffer, &next, sizeof(uint8_t *));
+}
+
+int VoxelBufferPool::get_max_free_buffers() const {
+	return _max_free_buffers;
+}
+void VoxelBufferPool::set_max_free_buffers(const int value) {
+	_max_free_buffers = value;
+}
+
+uint64_t VoxelBufferPool::get_buffers_live() const {
+	return _buffers_live.get();
+}
+uint64_t VoxelBufferPool::get_buffers_free() const {
+	return _buffers_free.get();
+}
+uint64_t VoxelBufferPool::get_bytes_reserved() const {
+	return _bytes_reserved.get();
+}
+
+uint8_t *VoxelBufferPool::buffer_alloc(const uint32_t size) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(size == 0, NULL);
+
+	_buffers_live.increment();
+
+	SizeClass *sc = _size_class_get(size, false);
+
+	if (sc && sc->free_list) {
+		uint8_t *buffer = sc->free_list;
+		sc->free_list = free_list_next(buffer);
+		--sc->free_count;
+
+		_buffers_free.decrement();
+
+		return buffer;
+	}
+
+	_bytes_reserved.add(size);
+
+	return memnew_arr(uint8_t, size);
+}
+void VoxelBufferPool::buffer_free(uint8_t *buffer, const uint32_t size) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND(buffer == NULL);
+
+	_buffers_live.decrement();
+
+	//Too small to hold the list's link
+	if (size < sizeof(uint8_t *)) {
+		_bytes_reserved.sub(size);
+
+		memdelete_arr(buffer);
+		return;
+	}
+
+	SizeClass *sc = _size_class_get(size, true);
+
+	if (sc->free_count >= _max_free_buffers) {
+		_bytes_reserved.sub(size);
+
+		memdelete_arr(buffer);
+		return;
+	}
+
+	free_list_set_next(buffer, sc->free_list);
+	sc->free_list = buffer;
+	++sc->free_count;
+
+	_buffers_free.increment();
+}
+
+void VoxelBufferPool::clear() {
+	_THREAD_SAFE_METHOD_
+
+	for (int b = 0; b < SIZE_CLASS_BUCKET_COUNT; ++b) {
+		for (int i = 0; i < _size_classes[b].size(); ++i) {
+			const SizeClass &sc = _size_classes[b][i];
+
+			uint8_t *buffer = sc.free_list;
+
+			while (buffer) {
+				uint8_t *next = free_list_next(buffer);
+				memdelete_arr(buffer);
+				buffer = next;
+			}
+
+			_bytes_reserved.sub(static_cast<uint64_t>(sc.size) * sc.free_count);
+		}
+
+		_size_classes[b].clear();
+	}
+
+	_buffers_free.set(0);
+}
+
+VoxelBufferPool::SizeClass *VoxelBufferPool::_size_class_get(const uint32_t size, const bool create) {
+	Vector<SizeClass> &bucket = _size_classes[nearest_shift(size)];
+
+	for (int i = 0; i < bucket.size(); ++i) {
+		if (bucket[i].size == size)
+			return &bucket.write[i];
+	}
+
+	if (!create)
+		return NULL;
+
+	SizeClass sc;
+	sc.size = size;
+
+	bucket.push_back(sc);
+
+	return &bucket.write[bucket.size() - 1];
+}
+
+VoxelBufferPool::VoxelBufferPool() {
+	_max_free_buffers = 1024;
+}
+
+VoxelBufferPool::~VoxelBufferPool() {
+	clear();
+}
+
+void VoxelBufferPool::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_max_free_buffers"), &VoxelBufferPool::get_max_free_buffers);
+	ClassDB::bind_method(D_METHOD("set_max_free_buffers", "value"), &VoxelBufferPool::set_max_free_buffers);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_free_buffers"), "set_max_free_buffers", "get_max_free_buffers");
+
+	ClassDB::bind_method(D_METHOD("get_buffers_live"), &VoxelBufferPool::get_buffers_live);
+	ClassDB::bind_method(D_METHOD("get_buffers_free"), &VoxelBufferPool::get_buffers_free);
+	ClassDB::bind_method(D_METHOD("get_bytes_reserved"), &VoxelBufferPool::get_bytes_reserved);
+
+	ClassDB::bind_method(D_METHOD("clear"), &VoxelBufferPool::clear);
+}
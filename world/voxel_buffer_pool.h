@@ -0,0 +1,98 @@
+/*
+Copyright (c) 2019-2020 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef VOXEL_BUFFER_POOL_H
+#define VOXEL_BUFFER_POOL_H
+
+#include "core/version.h"
+
+#if VERSION_MAJOR > 3
+#include "core/object/reference.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/vector.h"
+#else
+#include "core/reference.h"
+#include "core/safe_refcount.h"
+#include "core/vector.h"
+#endif
+
+#include "core/os/mutex.h"
+#include "core/os/thread_safe.h"
+
+//Keeps freed channel buffers around, grouped by their size, so chunks can reuse them.
+//Every chunk in a world uses the same few sizes, so a steadily streaming world won't need to hit the allocator.
+class VoxelBufferPool : public Reference {
+	GDCLASS(VoxelBufferPool, Reference);
+
+	_THREAD_SAFE_CLASS_
+
+public:
+	int get_max_free_buffers() const;
+	void set_max_free_buffers(const int value);
+
+	uint64_t get_buffers_live() const;
+	uint64_t get_buffers_free() const;
+	uint64_t get_bytes_reserved() const;
+
+	uint8_t *buffer_alloc(const uint32_t size);
+	void buffer_free(uint8_t *buffer, const uint32_t size);
+
+	void clear();
+
+	VoxelBufferPool();
+	~VoxelBufferPool();
+
+protected:
+	static void _bind_methods();
+
+	//The free buffers form a singly linked list, every one stores the next one's address in it's first bytes,
+	//so freeing, and reusing them never allocates
+	struct SizeClass {
+		uint32_t size;
+		uint8_t *free_list;
+		int free_count;
+
+		SizeClass() {
+			size = 0;
+			free_list = NULL;
+			free_count = 0;
+		}
+	};
+
+	enum {
+		SIZE_CLASS_BUCKET_COUNT = 33,
+	};
+
+	//Size classes are bucketed by nearest_shift(size), a bucket usually holds only one or two of them
+	SizeClass *_size_class_get(const uint32_t size, const bool create);
+
+	int _max_free_buffers;
+
+	//Changed under the lock, but read without it
+	SafeNumeric<uint64_t> _buffers_live;
+	SafeNumeric<uint64_t> _buffers_free;
+	SafeNumeric<uint64_t> _bytes_reserved;
+
+	Vector<SizeClass> _size_classes[SIZE_CLASS_BUCKET_COUNT];
+};
+
+#endif
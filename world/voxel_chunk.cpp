@@ -24,8 +24,12 @@ SOFTWARE.
 
 #include "voxel_world.h"
 
+//For LZ4_attach_dictionary
+#define LZ4_STATIC_LINKING_ONLY
 #include "../thirdparty/lz4/lz4.h"
 
+#include "core/io/marshalls.h"
+
 #include "../defines.h"
 
 #include "jobs/voxel_job.h"
@@ -33,8 +37,66 @@ SOFTWARE.
 
 #if THREAD_POOL_PRESENT
 #include "../../thread_pool/thread_pool.h"
+#else
+#include "jobs/voxel_job_scheduler.h"
+#endif
+
+//Per thread, so build / save threads can compress without allocating, or locking
+struct VoxelCompressionScratch {
+	LZ4_stream_t stream;
+	LZ4_stream_t dictionary_stream;
+	Vector<uint8_t> dictionary;
+	uint64_t dictionary_hash;
+
+	uint8_t *buffer;
+	int buffer_size;
+
+	uint8_t *get_buffer(const int size) {
+		if (size > buffer_size) {
+			if (buffer)
+				memfree(buffer);
+
+			buffer = reinterpret_cast<uint8_t *>(memalloc(size));
+			buffer_size = size;
+		}
+
+		return buffer;
+	}
+
+	void load_dictionary(const PoolByteArray &data, const uint64_t hash) {
+		//LZ4_loadDict() only references the data, so it needs a copy
+		dictionary.resize(data.size());
+
+#if !GODOT4
+		PoolByteArray::Read r = data.read();
+		memcpy(dictionary.ptrw(), r.ptr(), data.size());
+#else
+		memcpy(dictionary.ptrw(), data.ptr(), data.size());
 #endif
 
+		LZ4_initStream(&dictionary_stream, sizeof(LZ4_stream_t));
+		LZ4_loadDict(&dictionary_stream, reinterpret_cast<const char *>(dictionary.ptr()), dictionary.size());
+		dictionary_hash = hash;
+	}
+
+	VoxelCompressionScratch() {
+		LZ4_initStream(&stream, sizeof(LZ4_stream_t));
+		LZ4_initStream(&dictionary_stream, sizeof(LZ4_stream_t));
+		dictionary_hash = 0;
+		buffer = NULL;
+		buffer_size = 0;
+	}
+
+	~VoxelCompressionScratch() {
+		if (buffer)
+			memfree(buffer);
+	}
+};
+
+static thread_local VoxelCompressionScratch _compression_scratch;
+
+const String VoxelChunk::BINDING_STRING_DATA_LAYOUT = "Linear,Brick 4,Brick 8,Morton";
+
 _FORCE_INLINE_ bool VoxelChunk::get_is_build_threaded() const {
 	return _is_build_threaded;
 }
@@ -47,6 +109,9 @@ _FORCE_INLINE_ bool VoxelChunk::get_process() const {
 }
 _FORCE_INLINE_ void VoxelChunk::set_process(const bool value) {
 	_is_processing = value;
+
+	if (value && _voxel_world)
+		_voxel_world->active_process_add(this);
 }
 
 _FORCE_INLINE_ bool VoxelChunk::get_physics_process() const {
@@ -54,6 +119,9 @@ _FORCE_INLINE_ bool VoxelChunk::get_physics_process() const {
 }
 _FORCE_INLINE_ void VoxelChunk::set_physics_process(const bool value) {
 	_is_phisics_processing = value;
+
+	if (value && _voxel_world)
+		_voxel_world->active_physics_process_add(this);
 }
 
 bool VoxelChunk::get_visible() const {
@@ -70,6 +138,10 @@ _FORCE_INLINE_ bool VoxelChunk::get_is_generating() const {
 }
 _FORCE_INLINE_ void VoxelChunk::set_is_generating(const bool value) {
 	_is_generating = value;
+
+	//Turning it off can happen on worker threads, the world drops the chunk from it's list by itself
+	if (value && _voxel_world)
+		_voxel_world->active_generating_add(this);
 }
 
 bool VoxelChunk::is_in_tree() const {
@@ -188,6 +260,73 @@ _FORCE_INLINE_ void VoxelChunk::set_margin_end(const int value) {
 	_margin_end = value;
 }
 
+int VoxelChunk::get_data_layout() const {
+	return _data_layout;
+}
+void VoxelChunk::set_data_layout(const int layout) {
+	_channels_ensure_resident();
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_INDEX(layout, DATA_LAYOUT_MAX);
+	ERR_FAIL_COND_MSG(_snapshot_active, "Error, the data layout can't be changed while a build is reading the channels!");
+
+	if (_data_layout == layout)
+		return;
+
+	Vector<uint32_t> index_x;
+	Vector<uint32_t> index_y;
+	Vector<uint32_t> index_z;
+	uint32_t capacity;
+
+	_data_layout_build_tables(layout, index_x, index_y, index_z, capacity);
+
+	const uint32_t *ix = index_x.ptr();
+	const uint32_t *iy = index_y.ptr();
+	const uint32_t *iz = index_z.ptr();
+
+	//Existing data needs to be reordered
+	for (int i = 0; i < _channels.size(); ++i) {
+		if (_channels[i].shared)
+			_channel_detach(i, true);
+
+		if (_channels[i].packed)
+			channel_unpack(i);
+
+		//The low bytes, and the high bytes of 16 bit channels
+		VoxelChannel &ch = _channels.write[i];
+		uint8_t **planes[2] = { &ch.data, &ch.data_high };
+
+		for (int p = 0; p < 2; ++p) {
+			uint8_t *old_data = *planes[p];
+
+			if (!old_data)
+				continue;
+
+			uint8_t *data = _channel_buffer_alloc(capacity);
+			memset(data, old_data[get_data_index(0, 0, 0)], capacity);
+
+			for (int z = 0; z < _data_size_z; ++z) {
+				for (int x = 0; x < _data_size_x; ++x) {
+					for (int y = 0; y < _data_size_y; ++y) {
+						data[ix[x] + iy[y] + iz[z]] = old_data[get_data_index(x, y, z)];
+					}
+				}
+			}
+
+			_channel_buffer_free(old_data, get_data_size());
+
+			*planes[p] = data;
+		}
+	}
+
+	_data_layout = layout;
+	_data_capacity = capacity;
+	_data_index_x = index_x;
+	_data_index_y = index_y;
+	_data_index_z = index_z;
+}
+
 Ref<VoxelmanLibrary> VoxelChunk::get_library() {
 	return _library;
 }
@@ -211,12 +350,39 @@ void VoxelChunk::set_voxel_world(VoxelWorld *world) {
 void VoxelChunk::set_voxel_world_bind(Node *world) {
 	if (world == NULL) {
 		_voxel_world = NULL;
+		_world_index = -1;
+		_active_lists = 0;
 		return;
 	}
 
 	_voxel_world = Object::cast_to<VoxelWorld>(world);
 }
 
+int VoxelChunk::get_world_index() const {
+	return _world_index;
+}
+void VoxelChunk::set_world_index(const int index) {
+	_world_index = index;
+}
+
+int VoxelChunk::get_active_lists() const {
+	return _active_lists;
+}
+void VoxelChunk::set_active_lists(const int lists) {
+	_active_lists = lists;
+}
+
+int VoxelChunk::get_active_list_index(const int list) const {
+	ERR_FAIL_INDEX_V(list, ACTIVE_LIST_INDEX_COUNT, -1);
+
+	return _active_list_indices[list];
+}
+void VoxelChunk::set_active_list_index(const int list, const int index) {
+	ERR_FAIL_INDEX(list, ACTIVE_LIST_INDEX_COUNT);
+
+	_active_list_indices[list] = index;
+}
+
 Ref<VoxelJob> VoxelChunk::job_get(int index) const {
 	ERR_FAIL_INDEX_V(index, _jobs.size(), Ref<VoxelJob>());
 
@@ -242,329 +408,2111 @@ int VoxelChunk::job_get_count() const {
 int VoxelChunk::job_get_current_index() {
 	return _current_job;
 }
-void VoxelChunk::job_next() {
+void VoxelChunk::job_next() {
+	_THREAD_SAFE_METHOD_
+
+	++_current_job;
+
+	if (_current_job >= _jobs.size()) {
+		_current_job = -1;
+		finalize_build();
+
+		//Main thread code can read, and write the channels without locking,
+		//so the world packs them, and releases the snapshot in finalize_build_channels()
+		_build_channels_pending = true;
+
+		set_is_generating(false);
+
+		return;
+	}
+
+	Ref<VoxelJob> j = _jobs[_current_job];
+
+	if (!j.is_valid()) {
+		//skip if invalid
+		job_next();
+	}
+
+	j->reset();
+	j->set_complete(false);
+
+	if (j->get_build_phase_type() == VoxelJob::BUILD_PHASE_TYPE_NORMAL)
+		_job_submit(j);
+}
+void VoxelChunk::finalize_build_channels() {
+	_THREAD_SAFE_METHOD_
+
+	if (!_build_channels_pending || _is_generating)
+		return;
+
+	_build_channels_pending = false;
+
+	snapshot_release();
+
+	for (int i = 0; i < _channels.size(); ++i) {
+		//Derived channels are written again, and read through raw pointers by the next build,
+		//packing them would only make that build unpack them again
+		if (_channel_packing && !_channels[i].derived)
+			channel_pack(i);
+		else
+			channel_collapse(i);
+
+		_channel_high_collapse(i);
+	}
+}
+void VoxelChunk::_job_submit(const Ref<VoxelJob> &job) {
+#if THREAD_POOL_PRESENT
+	ThreadPool::get_singleton()->add_job(job);
+#else
+	if (_is_build_threaded && VoxelJobScheduler::get_singleton()->get_thread_count() > 0) {
+		VoxelJobScheduler::get_singleton()->add_job(job);
+		return;
+	}
+
+	//Main thread, in slices that fit into the world's frame budget
+	if (_voxel_world && _voxel_world->get_job_frame_budget() > 0) {
+		_voxel_world->job_sliced_add(job);
+		return;
+	}
+
+	job->execute();
+#endif
+}
+Ref<VoxelJob> VoxelChunk::job_get_current() {
+	_THREAD_SAFE_METHOD_
+
+	if (_current_job < 0 || _current_job >= _jobs.size()) {
+		return Ref<VoxelJob>();
+	}
+
+	return _jobs[_current_job];
+}
+
+//Voxel Data
+void VoxelChunk::channel_setup() {
+	ERR_FAIL_COND_MSG(!has_method("_channel_setup"), "VoxelChunk: _setup_channels() is missing! Please implement it!");
+
+	call("_channel_setup");
+}
+
+void VoxelChunk::set_size(const int size_x, const int size_y, const int size_z, const int margin_start, const int margin_end) {
+	_channels_ensure_resident();
+
+	if (_size_x == size_x && _size_y == size_y && _size_z == size_z && _margin_start == margin_start && _margin_end == margin_end) {
+		return;
+	}
+
+	for (int i = 0; i < _channels.size(); ++i) {
+		_channel_free(i);
+	}
+
+	set_edit_tracking(false);
+
+	channel_setup();
+
+	_size_x = size_x;
+	_size_y = size_y;
+	_size_z = size_z;
+
+	_data_size_x = size_x + margin_start + margin_end;
+	_data_size_y = size_y + margin_start + margin_end;
+	_data_size_z = size_z + margin_start + margin_end;
+
+	_margin_start = margin_start;
+	_margin_end = margin_end;
+
+	_data_layout_build_tables(_data_layout, _data_index_x, _data_index_y, _data_index_z, _data_capacity);
+}
+
+bool VoxelChunk::validate_data_position(const int x, const int y, const int z) const {
+	return x < _data_size_x && y < _data_size_y && z < _data_size_z;
+}
+
+uint8_t VoxelChunk::get_voxel(const int p_x, const int p_y, const int p_z, const int p_channel_index) const {
+	_channels_ensure_resident();
+
+	int x = p_x + _margin_start;
+	int y = p_y + _margin_start;
+	int z = p_z + _margin_start;
+
+	ERR_FAIL_INDEX_V(p_channel_index, _channels.size(), 0);
+	ERR_FAIL_COND_V_MSG(!validate_data_position(x, y, z), 0, "Error, index out of range! " + String::num(x) + " " + String::num(y) + " " + String::num(z));
+
+	const VoxelChannel &ch = _channels[p_channel_index];
+
+	if (ch.data)
+		return ch.data[get_data_index(x, y, z)];
+
+	if (ch.packed)
+		return _channel_packed_get(ch, get_data_index(x, y, z));
+
+	return ch.palette[0];
+}
+void VoxelChunk::set_voxel(const uint8_t p_value, const int p_x, const int p_y, const int p_z, const int p_channel_index) {
+	_channels_ensure_resident();
+
+	int x = p_x + _margin_start;
+	int y = p_y + _margin_start;
+	int z = p_z + _margin_start;
+
+	ERR_FAIL_INDEX(p_channel_index, _channels.size());
+	ERR_FAIL_COND_MSG(!validate_data_position(x, y, z), "Error, index out of range! " + String::num(x) + " " + String::num(y) + " " + String::num(z));
+
+	if (_channels[p_channel_index].shared)
+		_channel_detach(p_channel_index, true);
+
+	VoxelChannel &ch = _channels.write[p_channel_index];
+
+	if (_edit_tracking && !ch.derived)
+		_modified_mark(x, y, z);
+
+	if (ch.data_high)
+		ch.data_high[get_data_index(x, y, z)] = 0;
+
+	if (ch.bits_per_voxel == 0) {
+		if (ch.palette[0] == p_value)
+			return;
+
+		//Uniform channel, expand it lazily. The packed layout can already hold two values.
+		if (_channel_packing) {
+			uint32_t packed_size = _channel_get_packed_size(1);
+
+			ch.packed = _channel_buffer_alloc(packed_size);
+			memset(ch.packed, 0, packed_size);
+			ch.bits_per_voxel = 1;
+			ch.palette_size = 1;
+		}
+	}
+
+	if (ch.packed) {
+		int palette_index = _channel_palette_get_or_add(ch, p_value);
+
+		if (palette_index != -1) {
+			_channel_packed_set_index(ch, get_data_index(x, y, z), palette_index);
+			return;
+		}
+
+		//palette is full, fall back to dense storage
+		channel_unpack(p_channel_index);
+	}
+
+	uint8_t *data = channel_get_valid(p_channel_index);
+
+	data[get_data_index(x, y, z)] = p_value;
+}
+
+uint16_t VoxelChunk::get_voxel16(const int p_x, const int p_y, const int p_z, const int p_channel_index) const {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX_V(p_channel_index, _channels.size(), 0);
+
+	uint16_t value = get_voxel(p_x, p_y, p_z, p_channel_index);
+
+	const uint8_t *high = _channels[p_channel_index].data_high;
+
+	if (high && validate_data_position(p_x + _margin_start, p_y + _margin_start, p_z + _margin_start))
+		value |= high[get_index(p_x, p_y, p_z)] << 8;
+
+	return value;
+}
+void VoxelChunk::set_voxel16(const uint16_t p_value, const int p_x, const int p_y, const int p_z, const int p_channel_index) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX(p_channel_index, _channels.size());
+	ERR_FAIL_COND_MSG(p_value > 255 && !_channels[p_channel_index].wide, "Error, channel " + itos(p_channel_index) + " is 8 bit!");
+
+	//Also clears the high byte
+	set_voxel(p_value & 0xFF, p_x, p_y, p_z, p_channel_index);
+
+	if (p_value <= 255)
+		return;
+
+	uint8_t *high = channel_get_high_valid(p_channel_index);
+
+	ERR_FAIL_COND(!high);
+
+	high[get_index(p_x, p_y, p_z)] = p_value >> 8;
+}
+
+bool VoxelChunk::channel_get_derived(const int channel_index) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
+
+	return _channels[channel_index].derived;
+}
+void VoxelChunk::channel_set_derived(const int channel_index, const bool value) {
+	ERR_FAIL_INDEX(channel_index, _channels.size());
+
+	_channels.write[channel_index].derived = value;
+}
+
+int VoxelChunk::channel_get_width(const int channel_index) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), 8);
+
+	return _channels[channel_index].wide ? 16 : 8;
+}
+void VoxelChunk::channel_set_width(const int channel_index, const int bits) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX(channel_index, _channels.size());
+	ERR_FAIL_COND_MSG(bits != 8 && bits != 16, "Error, channels can only be 8, or 16 bit!");
+
+	if (bits == 8 && _channels[channel_index].data_high) {
+		if (_channels[channel_index].shared)
+			_channel_detach(channel_index, true);
+
+		_channel_buffer_free(_channels[channel_index].data_high, get_data_size());
+		_channels.write[channel_index].data_high = NULL;
+	}
+
+	_channels.write[channel_index].wide = bits == 16;
+}
+
+int VoxelChunk::channel_get_count() const {
+	return _channels.size();
+}
+
+void VoxelChunk::channel_set_count(const int count) {
+	_channels_ensure_resident();
+
+	if (count == _channels.size())
+		return;
+
+	if (_channels.size() >= count) {
+		for (int i = count; i < _channels.size(); ++i) {
+			_channel_free(i);
+		}
+
+		_channels.resize(count);
+		return;
+	}
+
+	int s = _channels.size();
+	_channels.resize(count);
+
+	for (int i = s; i < count; ++i) {
+		_channels.set(i, VoxelChannel());
+	}
+}
+bool VoxelChunk::channel_is_allocated(const int channel_index) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
+
+	const VoxelChannel &ch = _channels[channel_index];
+
+	return ch.data != NULL || ch.packed != NULL || ch.bits_per_voxel == 0;
+}
+void VoxelChunk::channel_ensure_allocated(const int channel_index, const uint8_t default_value) {
+	ERR_FAIL_INDEX(channel_index, _channels.size());
+
+	if (!channel_is_allocated(channel_index))
+		channel_allocate(channel_index, default_value);
+}
+void VoxelChunk::channel_allocate(const int channel_index, const uint8_t default_value) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX(channel_index, _channels.size());
+
+	if (channel_is_allocated(channel_index))
+		return;
+
+	uint32_t size = get_data_size();
+
+	uint8_t *ch = _channel_buffer_alloc(size);
+	memset(ch, default_value, size);
+
+	_channels.write[channel_index].data = ch;
+}
+void VoxelChunk::channel_fill(const uint8_t value, const int channel_index) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX(channel_index, _channels.size());
+
+	_modified_mark_full(channel_index);
+	_channel_free(channel_index);
+	_channel_set_uniform(_channels.write[channel_index], value);
+}
+void VoxelChunk::channel_dealloc(const int channel_index) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX(channel_index, _channels.size());
+
+	_modified_mark_full(channel_index);
+	_channel_free(channel_index);
+}
+
+uint8_t *VoxelChunk::channel_get(const int channel_index) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), NULL);
+
+	//The returned pointer can be written to
+	if (_channels[channel_index].shared)
+		_channel_detach(channel_index, true);
+
+	//Raw access needs the dense layout
+	if (_channels[channel_index].data == NULL)
+		channel_unpack(channel_index);
+
+	return _channels[channel_index].data;
+}
+bool VoxelChunk::validate_region(const int x, const int y, const int z, const int size_x, const int size_y, const int size_z) const {
+	_channels_ensure_resident();
+
+	int dx = x + _margin_start;
+	int dy = y + _margin_start;
+	int dz = z + _margin_start;
+
+	return dx >= 0 && dy >= 0 && dz >= 0 && size_x >= 0 && size_y >= 0 && size_z >= 0 &&
+		   dx + size_x <= _data_size_x && dy + size_y <= _data_size_y && dz + size_z <= _data_size_z;
+}
+
+bool VoxelChunk::copy_region_to(uint8_t *buffer, const AABB &region, const Vector<int> &channels, const bool from_snapshot) const {
+	return _region_copy(buffer, region, channels, from_snapshot);
+}
+bool VoxelChunk::write_region_from(const uint8_t *buffer, const AABB &region, const Vector<int> &channels) {
+	return _region_write(buffer, region, channels);
+}
+bool VoxelChunk::copy_region16_to(uint16_t *buffer, const AABB &region, const Vector<int> &channels, const bool from_snapshot) const {
+	return _region_copy(buffer, region, channels, from_snapshot);
+}
+bool VoxelChunk::write_region16_from(const uint16_t *buffer, const AABB &region, const Vector<int> &channels) {
+	return _region_write(buffer, region, channels);
+}
+
+template <class T>
+bool VoxelChunk::_region_copy(T *buffer, const AABB &region, const Vector<int> &channels, const bool from_snapshot) const {
+	_channels_ensure_resident();
+
+	ERR_FAIL_COND_V(!buffer, false);
+
+	int rx = static_cast<int>(region.position.x);
+	int ry = static_cast<int>(region.position.y);
+	int rz = static_cast<int>(region.position.z);
+	int rsx = static_cast<int>(region.size.x);
+	int rsy = static_cast<int>(region.size.y);
+	int rsz = static_cast<int>(region.size.z);
+
+	ERR_FAIL_COND_V_MSG(!validate_region(rx, ry, rz, rsx, rsy, rsz), false, "Error, region out of range! " + String(region));
+
+	int region_size = rsx * rsy * rsz;
+
+	const Vector<VoxelChannel> &source = (from_snapshot && _snapshot_active) ? _snapshot_channels : _channels;
+
+	for (int c = 0; c < channels.size(); ++c) {
+		int channel_index = channels[c];
+
+		ERR_FAIL_INDEX_V(channel_index, source.size(), false);
+
+		const VoxelChannel &ch = source[channel_index];
+		T *dst = buffer + c * region_size;
+
+		if (!ch.data && !ch.packed) {
+			if (sizeof(T) == 1) {
+				memset(dst, ch.palette[0], region_size);
+			} else {
+				for (int i = 0; i < region_size; ++i)
+					dst[i] = ch.palette[0];
+			}
+		} else {
+			for (int z = 0; z < rsz; ++z) {
+				for (int x = 0; x < rsx; ++x) {
+					T *column = dst + rsy * (x + rsx * z);
+
+					//Columns are continuous in the linear layout
+					if (sizeof(T) == 1 && ch.data && _data_layout == DATA_LAYOUT_LINEAR) {
+						memcpy(column, ch.data + get_index(rx + x, ry, rz + z), rsy);
+						continue;
+					}
+
+					for (int y = 0; y < rsy; ++y) {
+						int index = get_index(rx + x, ry + y, rz + z);
+
+						column[y] = ch.data ? ch.data[index] : _channel_packed_get(ch, index);
+					}
+				}
+			}
+		}
+
+		//8 bit regions only see the low bytes
+		if (sizeof(T) == 1 || !ch.data_high)
+			continue;
+
+		for (int z = 0; z < rsz; ++z) {
+			for (int x = 0; x < rsx; ++x) {
+				T *column = dst + rsy * (x + rsx * z);
+
+				for (int y = 0; y < rsy; ++y) {
+					column[y] |= ch.data_high[get_index(rx + x, ry + y, rz + z)] << 8;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+template <class T>
+bool VoxelChunk::_region_write(const T *buffer, const AABB &region, const Vector<int> &channels) {
+	_channels_ensure_resident();
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(!buffer, false);
+
+	int rx = static_cast<int>(region.position.x);
+	int ry = static_cast<int>(region.position.y);
+	int rz = static_cast<int>(region.position.z);
+	int rsx = static_cast<int>(region.size.x);
+	int rsy = static_cast<int>(region.size.y);
+	int rsz = static_cast<int>(region.size.z);
+
+	ERR_FAIL_COND_V_MSG(!validate_region(rx, ry, rz, rsx, rsy, rsz), false, "Error, region out of range! " + String(region));
+
+	int region_size = rsx * rsy * rsz;
+
+	for (int c = 0; c < channels.size(); ++c) {
+		int channel_index = channels[c];
+
+		ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
+
+		const T *src = buffer + c * region_size;
+		bool has_high = false;
+
+		if (sizeof(T) > 1) {
+			for (int i = 0; i < region_size && !has_high; ++i)
+				has_high = src[i] > 255;
+
+			ERR_FAIL_COND_V_MSG(has_high && !_channels[channel_index].wide, false, "Error, channel " + itos(channel_index) + " is 8 bit!");
+		}
+
+		if (_edit_tracking && !_channels[channel_index].derived) {
+			for (int z = 0; z < rsz; ++z) {
+				for (int x = 0; x < rsx; ++x) {
+					for (int y = 0; y < rsy; ++y) {
+						_modified_mark(rx + x + _margin_start, ry + y + _margin_start, rz + z + _margin_start);
+					}
+				}
+			}
+		}
+
+		const VoxelChannel &vc = _channels[channel_index];
+
+		//Don't expand uniform channels when nothing would change
+		if (!vc.data && !vc.packed && !vc.data_high && vc.bits_per_voxel == 0 && !has_high) {
+			int i = 0;
+
+			while (i < region_size && src[i] == vc.palette[0])
+				++i;
+
+			if (i == region_size)
+				continue;
+		}
+
+		uint8_t *data = channel_get_valid(channel_index);
+
+		for (int z = 0; z < rsz; ++z) {
+			for (int x = 0; x < rsx; ++x) {
+				const T *column = src + rsy * (x + rsx * z);
+
+				if (sizeof(T) == 1 && _data_layout == DATA_LAYOUT_LINEAR) {
+					memcpy(data + get_index(rx + x, ry, rz + z), column, rsy);
+					continue;
+				}
+
+				for (int y = 0; y < rsy; ++y) {
+					data[get_index(rx + x, ry + y, rz + z)] = column[y] & 0xFF;
+				}
+			}
+		}
+
+		//8 bit writes clear the high bytes, like set_voxel()
+		uint8_t *high = has_high ? channel_get_high_valid(channel_index) : _channels[channel_index].data_high;
+
+		if (!high)
+			continue;
+
+		for (int z = 0; z < rsz; ++z) {
+			for (int x = 0; x < rsx; ++x) {
+				const T *column = src + rsy * (x + rsx * z);
+
+				for (int y = 0; y < rsy; ++y) {
+					high[get_index(rx + x, ry + y, rz + z)] = column[y] >> 8;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+PoolByteArray VoxelChunk::copy_region_to_bind(const AABB &region, const PoolIntArray &channels) const {
+	PoolByteArray arr;
+
+	Vector<int> chs;
+	chs.resize(channels.size());
+
+	for (int i = 0; i < channels.size(); ++i) {
+		chs.write[i] = channels[i];
+	}
+
+	int size = static_cast<int>(region.size.x) * static_cast<int>(region.size.y) * static_cast<int>(region.size.z) * chs.size();
+
+	if (size <= 0)
+		return arr;
+
+	arr.resize(size);
+
+#if !GODOT4
+	PoolByteArray::Write w = arr.write();
+
+	if (!copy_region_to(w.ptr(), region, chs)) {
+		w.release();
+		arr.resize(0);
+	}
+#else
+	if (!copy_region_to(arr.ptrw(), region, chs))
+		arr.resize(0);
+#endif
+
+	return arr;
+}
+void VoxelChunk::write_region_from_bind(const PoolByteArray &buffer, const AABB &region, const PoolIntArray &channels) {
+	Vector<int> chs;
+	chs.resize(channels.size());
+
+	for (int i = 0; i < channels.size(); ++i) {
+		chs.write[i] = channels[i];
+	}
+
+	int size = static_cast<int>(region.size.x) * static_cast<int>(region.size.y) * static_cast<int>(region.size.z) * chs.size();
+
+	ERR_FAIL_COND_MSG(buffer.size() < size, "Error, buffer is too small for the region!");
+
+	if (size <= 0)
+		return;
+
+#if !GODOT4
+	PoolByteArray::Read r = buffer.read();
+
+	write_region_from(r.ptr(), region, chs);
+#else
+	write_region_from(buffer.ptr(), region, chs);
+#endif
+}
+
+uint8_t *VoxelChunk::channel_get_valid(const int channel_index, const uint8_t default_value) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), 0);
+
+	uint8_t *ch = channel_get(channel_index);
+
+	if (ch == NULL) {
+		channel_allocate(channel_index, default_value);
+
+		return _channels[channel_index].data;
+	}
+
+	return ch;
+}
+
+uint8_t *VoxelChunk::channel_get_high(const int channel_index) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), NULL);
+
+	if (_channels[channel_index].shared)
+		_channel_detach(channel_index, true);
+
+	return _channels[channel_index].data_high;
+}
+uint8_t *VoxelChunk::channel_get_high_valid(const int channel_index) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), NULL);
+	ERR_FAIL_COND_V_MSG(!_channels[channel_index].wide, NULL, "Error, channel " + itos(channel_index) + " is 8 bit!");
+
+	uint8_t *high = channel_get_high(channel_index);
+
+	if (high)
+		return high;
+
+	uint32_t size = get_data_size();
+
+	high = _channel_buffer_alloc(size);
+	memset(high, 0, size);
+
+	_channels.write[channel_index].data_high = high;
+
+	return high;
+}
+
+PoolByteArray VoxelChunk::channel_get_array(const int channel_index) const {
+	_channels_ensure_resident();
+
+	PoolByteArray arr;
+
+	uint32_t size = get_data_size();
+
+	if (channel_index >= _channels.size())
+		return arr;
+
+	const VoxelChannel &ch = _channels[channel_index];
+
+	if (ch.data == NULL && ch.packed == NULL && ch.bits_per_voxel != 0)
+		return arr;
+
+	//16 bit channels store the low bytes first, then the high bytes
+	arr.resize(ch.wide ? size * 2 : size);
+
+#if !GODOT4
+	PoolByteArray::Write w = arr.write();
+	uint8_t *dst = w.ptr();
+#else
+	uint8_t *dst = arr.ptrw();
+#endif
+
+	_channel_decode(ch, dst);
+
+	if (ch.wide) {
+		if (ch.data_high)
+			memcpy(dst + size, ch.data_high, size);
+		else
+			memset(dst + size, 0, size);
+	}
+
+	return arr;
+}
+void VoxelChunk::channel_set_array(const int channel_index, const PoolByteArray &array) {
+	_channels_ensure_resident();
+
+	if (array.size() == 0)
+		return;
+
+	if (_channels.size() <= channel_index)
+		channel_set_count(channel_index + 1);
+
+	int size = get_data_size();
+	bool wide = _channels[channel_index].wide;
+
+	ERR_FAIL_COND_MSG(array.size() != size && !(wide && array.size() == size * 2), "Error, the array's size (" + itos(array.size()) + ") doesn't match the chunk's data size (" + itos(size) + ")!");
+
+	_modified_mark_full(channel_index);
+
+	if (_channels[channel_index].shared)
+		_channel_detach(channel_index, false);
+
+	if (_channels[channel_index].data == NULL)
+		channel_dealloc(channel_index);
+
+	uint8_t *ch = _channels[channel_index].data;
+
+	if (ch == NULL) {
+		ch = _channel_buffer_alloc(size);
+		_channels.write[channel_index].data = ch;
+	}
+
+#if !GODOT4
+	PoolByteArray::Read r = array.read();
+	const uint8_t *src = r.ptr();
+#else
+	const uint8_t *src = array.ptr();
+#endif
+
+	memcpy(ch, src, size);
+
+	if (_channels[channel_index].data_high) {
+		_channel_buffer_free(_channels[channel_index].data_high, size);
+		_channels.write[channel_index].data_high = NULL;
+	}
+
+	if (array.size() == size)
+		return;
+
+	memcpy(channel_get_high_valid(channel_index), src + size, size);
+
+	_channel_high_collapse(channel_index);
+}
+
+PoolByteArray VoxelChunk::channel_get_compressed(const int channel_index) const {
+	_channels_ensure_resident();
+
+	PoolByteArray arr;
+
+	int size = get_data_size();
+
+	if (channel_index >= _channels.size())
+		return arr;
+
+	const VoxelChannel &vc = _channels[channel_index];
+
+	if (vc.data == NULL && vc.packed == NULL && vc.bits_per_voxel != 0)
+		return arr;
+
+	//16 bit channels compress the low, and the high bytes together
+	int source_size = vc.wide ? size * 2 : size;
+
+	uint8_t *ch = vc.data;
+
+	if (ch == NULL || vc.wide) {
+		ch = _channel_buffer_alloc(source_size);
+		_channel_decode(vc, ch);
+
+		if (vc.wide) {
+			if (vc.data_high)
+				memcpy(ch + size, vc.data_high, size);
+			else
+				memset(ch + size, 0, size);
+		}
+	}
+
+	int bound = LZ4_compressBound(source_size);
+	arr.resize(bound);
+
+#if !GODOT4
+	PoolByteArray::Write w = arr.write();
+
+	int ns = LZ4_compress_default(reinterpret_cast<char *>(ch), reinterpret_cast<char *>(w.ptr()), source_size, bound);
+
+	w.release();
+#else
+	int ns = LZ4_compress_default(reinterpret_cast<char *>(ch), reinterpret_cast<char *>(arr.ptrw()), source_size, bound);
+#endif
+	arr.resize(ns);
+
+	if (ch != vc.data)
+		_channel_buffer_free(ch, source_size);
+
+	return arr;
+}
+void VoxelChunk::channel_set_compressed(const int channel_index, const PoolByteArray &data) {
+	_channels_ensure_resident();
+
+	if (data.size() == 0)
+		return;
+
+	int size = get_data_size();
+
+	if (_channels.size() <= channel_index)
+		channel_set_count(channel_index + 1);
+
+	_modified_mark_full(channel_index);
+
+	if (_channels[channel_index].shared)
+		_channel_detach(channel_index, false);
+
+	if (_channels[channel_index].data == NULL)
+		channel_dealloc(channel_index);
+
+	uint8_t *ch = _channels[channel_index].data;
+
+	if (ch == NULL) {
+		ch = _channel_buffer_alloc(size);
+		_channels.write[channel_index].data = ch;
+	}
+
+	if (_channels[channel_index].data_high) {
+		_channel_buffer_free(_channels[channel_index].data_high, size);
+		_channels.write[channel_index].data_high = NULL;
+	}
+
+	int ds = data.size();
+
+#if !GODOT4
+	PoolByteArray::Read r = data.read();
+
+	//We are not going to write to it
+	uint8_t *data_arr = const_cast<uint8_t *>(r.ptr());
+#else
+	//We are not going to write to it
+	uint8_t *data_arr = const_cast<uint8_t *>(data.ptr());
+#endif
+
+	if (!_channels[channel_index].wide) {
+		LZ4_decompress_safe(reinterpret_cast<char *>(data_arr), reinterpret_cast<char *>(ch), ds, size);
+		return;
+	}
+
+	uint8_t *decompressed = _channel_buffer_alloc(size * 2);
+
+	int dsize = LZ4_decompress_safe(reinterpret_cast<char *>(data_arr), reinterpret_cast<char *>(decompressed), ds, size * 2);
+
+	memcpy(ch, decompressed, MIN(MAX(dsize, 0), size));
+
+	if (dsize > size) {
+		uint8_t *high = channel_get_high_valid(channel_index);
+
+		memcpy(high, decompressed + size, dsize - size);
+
+		_channel_high_collapse(channel_index);
+	}
+
+	_channel_buffer_free(decompressed, size * 2);
+}
+
+PoolByteArray VoxelChunk::data_serialize(const bool include_derived) const {
+	_channels_ensure_resident();
+
+	PoolByteArray arr;
+	arr.resize(_data_serialized_size(include_derived));
+
+#if !GODOT4
+	PoolByteArray::Write w = arr.write();
+	_data_serialize_to(w.ptr(), include_derived);
+#else
+	_data_serialize_to(arr.ptrw(), include_derived);
+#endif
+
+	return arr;
+}
+
+bool VoxelChunk::data_deserialize(const PoolByteArray &data) {
+#if !GODOT4
+	PoolByteArray::Read r = data.read();
+	return _data_deserialize_from(r.ptr(), data.size());
+#else
+	return _data_deserialize_from(data.ptr(), data.size());
+#endif
+}
+
+PoolByteArray VoxelChunk::data_get_compressed(const bool include_derived) const {
+	PoolByteArray arr;
+
+	int size = data_compress_to(arr, 0, include_derived);
+	arr.resize(size);
+
+	return arr;
+}
+
+bool VoxelChunk::data_set_compressed(const PoolByteArray &data) {
+#if !GODOT4
+	PoolByteArray::Read r = data.read();
+	return data_decompress_from(r.ptr(), data.size());
+#else
+	return data_decompress_from(data.ptr(), data.size());
+#endif
+}
+
+int VoxelChunk::data_compress_to(PoolByteArray &dst, const int offset, const bool include_derived) const {
+	_channels_ensure_resident();
+
+	VoxelCompressionScratch &scratch = _compression_scratch;
+
+	int raw_size = _data_serialized_size(include_derived);
+	uint8_t *raw = scratch.get_buffer(raw_size);
+
+	_data_serialize_to(raw, include_derived);
+
+	uint64_t dictionary_hash = 0;
+
+	if (_voxel_world)
+		dictionary_hash = _voxel_world->get_compression_dictionary_hash();
+
+	//Looked up by hash, so it's the same dictionary even if it got replaced in the meantime
+	if (dictionary_hash != 0 && scratch.dictionary_hash != dictionary_hash) {
+		PoolByteArray dictionary;
+
+		if (_voxel_world->compression_dictionary_find(dictionary_hash, dictionary))
+			scratch.load_dictionary(dictionary, dictionary_hash);
+		else
+			dictionary_hash = 0;
+	}
+
+	int bound = LZ4_compressBound(raw_size);
+
+	dst.resize(offset + DATA_COMPRESSED_HEADER_SIZE + bound);
+
+#if !GODOT4
+	PoolByteArray::Write w = dst.write();
+	uint8_t *d = w.ptr() + offset;
+#else
+	uint8_t *d = dst.ptrw() + offset;
+#endif
+
+	d[0] = DATA_COMPRESSED_VERSION;
+	encode_uint32(raw_size, d + 1);
+	encode_uint64(dictionary_hash, d + 5);
+
+	//The dictionary is only hashed once per thread, every chunk just references it
+	LZ4_resetStream_fast(&scratch.stream);
+
+	if (dictionary_hash != 0)
+		LZ4_attach_dictionary(&scratch.stream, &scratch.dictionary_stream);
+
+	int ns = LZ4_compress_fast_continue(&scratch.stream, reinterpret_cast<const char *>(raw), reinterpret_cast<char *>(d + DATA_COMPRESSED_HEADER_SIZE), raw_size, bound, 1);
+
+	return offset + DATA_COMPRESSED_HEADER_SIZE + ns;
+}
+
+bool VoxelChunk::data_decompress_from(const uint8_t *src, const int size) {
+	ERR_FAIL_COND_V(size < DATA_COMPRESSED_HEADER_SIZE, false);
+	ERR_FAIL_COND_V_MSG(src[0] != DATA_COMPRESSED_VERSION, false, "Error, unknown compressed chunk data version!");
+
+	int raw_size = decode_uint32(src + 1);
+	uint64_t dictionary_hash = decode_uint64(src + 5);
+	int csize = size - DATA_COMPRESSED_HEADER_SIZE;
+
+	//lz4 can't expand data more than 255 times
+	ERR_FAIL_COND_V_MSG(raw_size <= 0 || raw_size / 255 > csize, false, "Error, the compressed chunk data is corrupt!");
+
+	VoxelCompressionScratch &scratch = _compression_scratch;
+	uint8_t *raw = scratch.get_buffer(raw_size);
+	int ds;
+
+	if (dictionary_hash != 0) {
+		if (scratch.dictionary_hash != dictionary_hash) {
+			PoolByteArray dictionary;
+
+			ERR_FAIL_COND_V_MSG(!_voxel_world || !_voxel_world->compression_dictionary_find(dictionary_hash, dictionary), false, "Error, the chunk data was compressed with an unknown dictionary!");
+
+			scratch.load_dictionary(dictionary, dictionary_hash);
+		}
+
+		ds = LZ4_decompress_safe_usingDict(reinterpret_cast<const char *>(src + DATA_COMPRESSED_HEADER_SIZE), reinterpret_cast<char *>(raw), csize, raw_size, reinterpret_cast<const char *>(scratch.dictionary.ptr()), scratch.dictionary.size());
+	} else {
+		ds = LZ4_decompress_safe(reinterpret_cast<const char *>(src + DATA_COMPRESSED_HEADER_SIZE), reinterpret_cast<char *>(raw), csize, raw_size);
+	}
+
+	ERR_FAIL_COND_V_MSG(ds != raw_size, false, "Error, the compressed chunk data is corrupt!");
+
+	return _data_deserialize_from(raw, raw_size);
+}
+
+bool VoxelChunk::data_map(const uint8_t *d, const int size, const Ref<Reference> &owner) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_COND_V(size < DATA_HEADER_SIZE, false);
+
+	//Reordering would write the data anyway
+	if (d[1] != _data_layout)
+		return _data_deserialize_from(d, size);
+
+	ERR_FAIL_COND_V_MSG(_snapshot_active, false, "Error, the data can't be replaced while a build is reading the channels!");
+	ERR_FAIL_COND_V_MSG(d[0] != DATA_VERSION, false, "Error, unknown chunk data version!");
+
+	if (decode_uint16(d + 4) != _data_size_x || decode_uint16(d + 6) != _data_size_y || decode_uint16(d + 8) != _data_size_z) {
+		ERR_FAIL_V_MSG(false, "Error, the data was saved from a chunk with a different size!");
+	}
+
+	int channel_count = decode_uint16(d + 2);
+
+	if (_channels.size() < channel_count)
+		channel_set_count(channel_count);
+
+	int data_size = get_data_size();
+	int offset = DATA_HEADER_SIZE;
+
+	for (int i = 0; i < channel_count; ++i) {
+		ERR_FAIL_COND_V_MSG(offset + 2 > size, false, "Error, the chunk data is corrupt!");
+
+		uint8_t type = d[offset];
+		bool wide = d[offset + 1] == 16;
+		offset += 2;
+
+		_modified_mark_full(i);
+		_channel_free(i);
+
+		VoxelChannel &ch = _channels.write[i];
+
+		ch.wide = wide;
+
+		if (type == DATA_CHANNEL_NONE)
+			continue;
+
+		if (type == DATA_CHANNEL_UNIFORM) {
+			ERR_FAIL_COND_V_MSG(offset >= size, false, "Error, the chunk data is corrupt!");
+
+			_channel_set_uniform(ch, d[offset++]);
+			continue;
+		}
+
+		int channel_size = wide ? data_size * 2 : data_size;
+
+		ERR_FAIL_COND_V_MSG(type != DATA_CHANNEL_RAW || offset + channel_size > size, false, "Error, the chunk data is corrupt!");
+
+		ch.data = const_cast<uint8_t *>(d + offset);
+
+		if (wide)
+			ch.data_high = const_cast<uint8_t *>(d + offset + data_size);
+
+		ch.read_only = true;
+		ch.shared = true;
+
+		offset += channel_size;
+	}
+
+	_data_mapping_owner = owner;
+
+	return true;
+}
+
+bool VoxelChunk::channel_is_read_only(const int channel_index) const {
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
+
+	return _channels[channel_index].read_only;
+}
+
+int VoxelChunk::_data_serialized_size(const bool include_derived) const {
+	int size = get_data_size();
+	int total = DATA_HEADER_SIZE;
+
+	//Sizes first, so the buffer only needs to be allocated once
+	for (int i = 0; i < _channels.size(); ++i) {
+		const VoxelChannel &ch = _channels[i];
+
+		total += 2;
+
+		if (ch.derived && !include_derived)
+			continue;
+
+		if (!ch.data && !ch.packed && !ch.data_high) {
+			if (ch.bits_per_voxel == 0)
+				total += 1;
+
+			continue;
+		}
+
+		total += ch.wide ? size * 2 : size;
+	}
+
+	return total;
+}
+
+void VoxelChunk::_data_serialize_to(uint8_t *d, const bool include_derived) const {
+	int size = get_data_size();
+
+	d[0] = DATA_VERSION;
+	d[1] = _data_layout;
+	encode_uint16(_channels.size(), d + 2);
+	encode_uint16(_data_size_x, d + 4);
+	encode_uint16(_data_size_y, d + 6);
+	encode_uint16(_data_size_z, d + 8);
+
+	int offset = DATA_HEADER_SIZE;
+
+	for (int i = 0; i < _channels.size(); ++i) {
+		const VoxelChannel &ch = _channels[i];
+
+		d[offset + 1] = ch.wide ? 16 : 8;
+
+		if ((ch.derived && !include_derived) || (!ch.data && !ch.packed && !ch.data_high && ch.bits_per_voxel != 0)) {
+			d[offset] = DATA_CHANNEL_NONE;
+			offset += 2;
+		} else if (!ch.data && !ch.packed && !ch.data_high) {
+			d[offset] = DATA_CHANNEL_UNIFORM;
+			d[offset + 2] = ch.palette[0];
+			offset += 3;
+		} else {
+			d[offset] = DATA_CHANNEL_RAW;
+			offset += 2;
+
+			_channel_decode(ch, d + offset);
+			offset += size;
+
+			if (ch.wide) {
+				if (ch.data_high)
+					memcpy(d + offset, ch.data_high, size);
+				else
+					memset(d + offset, 0, size);
+
+				offset += size;
+			}
+		}
+	}
+}
+
+bool VoxelChunk::_data_deserialize_from(const uint8_t *d, const int data_size) {
+	_channels_ensure_resident();
+
+	ERR_FAIL_COND_V(data_size < DATA_HEADER_SIZE, false);
+	ERR_FAIL_COND_V_MSG(_snapshot_active, false, "Error, the data can't be replaced while a build is reading the channels!");
+
+	ERR_FAIL_COND_V_MSG(d[0] != DATA_VERSION, false, "Error, unknown chunk data version!");
+	ERR_FAIL_INDEX_V(d[1], DATA_LAYOUT_MAX, false);
+
+	if (decode_uint16(d + 4) != _data_size_x || decode_uint16(d + 6) != _data_size_y || decode_uint16(d + 8) != _data_size_z) {
+		ERR_FAIL_V_MSG(false, "Error, the data was saved from a chunk with a different size!");
+	}
+
+	int channel_count = decode_uint16(d + 2);
+
+	if (_channels.size() < channel_count)
+		channel_set_count(channel_count);
+
+	for (int i = 0; i < channel_count; ++i) {
+		_modified_mark_full(i);
+		_channel_free(i);
+	}
+
+	//The raw channels are in the stored layout, they get converted back at the end
+	int layout = _data_layout;
+	set_data_layout(d[1]);
+
+	int size = get_data_size();
+	int offset = DATA_HEADER_SIZE;
+	bool valid = true;
+
+	for (int i = 0; i < channel_count; ++i) {
+		if (offset + 2 > data_size) {
+			valid = false;
+			break;
+		}
+
+		uint8_t type = d[offset];
+		uint8_t width = d[offset + 1];
+		offset += 2;
+
+		if (width != 8 && width != 16) {
+			valid = false;
+			break;
+		}
+
+		VoxelChannel &ch = _channels.write[i];
+
+		ch.wide = width == 16;
+
+		if (type == DATA_CHANNEL_NONE)
+			continue;
+
+		if (type == DATA_CHANNEL_UNIFORM && offset < data_size) {
+			_channel_set_uniform(ch, d[offset++]);
+			continue;
+		}
+
+		int channel_size = ch.wide ? size * 2 : size;
+
+		if (type != DATA_CHANNEL_RAW || offset + channel_size > data_size) {
+			valid = false;
+			break;
+		}
+
+		ch.data = _channel_buffer_alloc(size);
+		memcpy(ch.data, d + offset, size);
+
+		if (ch.wide) {
+			ch.data_high = _channel_buffer_alloc(size);
+			memcpy(ch.data_high, d + offset + size, size);
+		}
+
+		offset += channel_size;
+	}
+
+	set_data_layout(layout);
+
+	for (int i = 0; i < channel_count; ++i) {
+		if (!_channels[i].data || _channels[i].shared)
+			continue;
+
+		_channel_high_collapse(i);
+
+		if (_channel_packing)
+			channel_pack(i);
+		else
+			channel_collapse(i);
+	}
+
+	ERR_FAIL_COND_V_MSG(!valid, false, "Error, the chunk data is corrupt!");
+
+	return true;
+}
+
+bool VoxelChunk::get_channel_packing() const {
+	return _channel_packing;
+}
+void VoxelChunk::set_channel_packing(const bool value) {
+	_channel_packing = value;
+}
+
+Ref<VoxelBufferPool> VoxelChunk::get_buffer_pool() const {
+	return _buffer_pool;
+}
+void VoxelChunk::set_buffer_pool(const Ref<VoxelBufferPool> &pool) {
+	_channels_ensure_resident();
+
+	_THREAD_SAFE_METHOD_
+
+	if (_buffer_pool == pool)
+		return;
+
+	Ref<VoxelBufferPool> old_pool = _buffer_pool;
+
+	//Buffers need to be given back to the pool they came from
+	for (int i = 0; i < _channels.size(); ++i) {
+		if (_channels[i].shared)
+			_channel_detach(i, true);
+
+		VoxelChannel &ch = _channels.write[i];
+
+		uint8_t *old_data = ch.data;
+		uint8_t *old_packed = ch.packed;
+		uint8_t *old_high = ch.data_high;
+		uint32_t packed_size = _channel_get_packed_size(ch.bits_per_voxel);
+
+		_buffer_pool = pool;
+
+		if (old_data) {
+			ch.data = _channel_buffer_alloc(get_data_size());
+			memcpy(ch.data, old_data, get_data_size());
+		}
+
+		if (old_packed) {
+			ch.packed = _channel_buffer_alloc(packed_size);
+			memcpy(ch.packed, old_packed, packed_size);
+		}
+
+		if (old_high) {
+			ch.data_high = _channel_buffer_alloc(get_data_size());
+			memcpy(ch.data_high, old_high, get_data_size());
+		}
+
+		_buffer_pool = old_pool;
+
+		if (old_data)
+			_channel_buffer_free(old_data, get_data_size());
+
+		if (old_packed)
+			_channel_buffer_free(old_packed, packed_size);
+
+		if (old_high)
+			_channel_buffer_free(old_high, get_data_size());
+	}
+
+	_buffer_pool = pool;
+}
+
+bool VoxelChunk::channel_pack(const int channel_index) {
+	_channels_ensure_resident();
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
+
+	//Mapped, and snapshot data would have to be copied first, just to be shrunk. They get packed after they are written.
+	if (_channels[channel_index].shared)
+		return false;
+
+	VoxelChannel &ch = _channels.write[channel_index];
+
+	if (ch.bits_per_voxel == 0)
+		return true;
+
+	//Edits can leave unused palette entries behind, so packed channels get rescanned
+	if (ch.packed)
+		channel_unpack(channel_index);
+
+	if (ch.data == NULL)
+		return false;
+
+	_channel_fill_padding(ch.data);
+
+	uint32_t size = get_data_size();
+
+	uint8_t lookup[256];
+	memset(lookup, 0xFF, 256);
+
+	uint8_t palette[CHANNEL_PALETTE_MAX_SIZE];
+	int palette_size = 0;
+
+	for (uint32_t i = 0; i < size; ++i) {
+		uint8_t v = ch.data[i];
+
+		if (lookup[v] != 0xFF)
+			continue;
+
+		if (palette_size == CHANNEL_PALETTE_MAX_SIZE)
+			return false;
+
+		lookup[v] = palette_size;
+		palette[palette_size++] = v;
+	}
+
+	if (palette_size == 1) {
+		_channel_buffer_free(ch.data, size);
+		ch.data = NULL;
+
+		_channel_set_uniform(ch, palette[0]);
+
+		return true;
+	}
+
+	int bits_per_voxel = 4;
+
+	if (palette_size <= 2)
+		bits_per_voxel = 1;
+	else if (palette_size <= 4)
+		bits_per_voxel = 2;
+
+	uint32_t packed_size = _channel_get_packed_size(bits_per_voxel);
+	uint8_t *packed = _channel_buffer_alloc(packed_size);
+	memset(packed, 0, packed_size);
+
+	ch.packed = packed;
+	ch.bits_per_voxel = bits_per_voxel;
+	ch.palette_size = palette_size;
+	memcpy(ch.palette, palette, palette_size);
+
+	for (uint32_t i = 0; i < size; ++i) {
+		_channel_packed_set_index(ch, i, lookup[ch.data[i]]);
+	}
+
+	_channel_buffer_free(ch.data, size);
+	ch.data = NULL;
+
+	return true;
+}
+void VoxelChunk::channel_unpack(const int channel_index) {
+	_channels_ensure_resident();
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_INDEX(channel_index, _channels.size());
+
+	if (_channels[channel_index].shared)
+		_channel_detach(channel_index, true);
+
+	VoxelChannel &ch = _channels.write[channel_index];
+
+	if (ch.data || (!ch.packed && ch.bits_per_voxel != 0))
+		return;
+
+	uint8_t *data = _channel_buffer_alloc(get_data_size());
+	_channel_decode(ch, data);
+
+	if (ch.packed)
+		_channel_buffer_free(ch.packed, _channel_get_packed_size(ch.bits_per_voxel));
+
+	ch.packed = NULL;
+	ch.data = data;
+	ch.bits_per_voxel = 8;
+	ch.palette_size = 0;
+	ch.palette[0] = 0;
+}
+void VoxelChunk::channels_pack() {
+	for (int i = 0; i < _channels.size(); ++i) {
+		channel_pack(i);
+	}
+}
+bool VoxelChunk::channel_is_packed(const int channel_index) const {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
+
+	return _channels[channel_index].packed != NULL;
+}
+bool VoxelChunk::channel_is_uniform(const int channel_index) const {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
+
+	const VoxelChannel &ch = _channels[channel_index];
+
+	return ch.data == NULL && ch.packed == NULL && ch.data_high == NULL;
+}
+bool VoxelChunk::channel_collapse(const int channel_index) {
+	_channels_ensure_resident();
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
+
+	//Same as channel_pack()
+	if (_channels[channel_index].shared)
+		return false;
+
+	VoxelChannel &ch = _channels.write[channel_index];
+
+	if (ch.packed) {
+		if (ch.palette_size > 1)
+			return false;
+
+		_channel_buffer_free(ch.packed, _channel_get_packed_size(ch.bits_per_voxel));
+		ch.packed = NULL;
+
+		_channel_set_uniform(ch, ch.palette[0]);
+
+		return true;
+	}
+
+	if (ch.data == NULL)
+		return true;
+
+	_channel_fill_padding(ch.data);
+
+	uint32_t size = get_data_size();
+	uint8_t v = ch.data[0];
+
+	for (uint32_t i = 1; i < size; ++i) {
+		if (ch.data[i] != v)
+			return false;
+	}
+
+	_channel_buffer_free(ch.data, size);
+	ch.data = NULL;
+
+	_channel_set_uniform(ch, v);
+
+	return true;
+}
+int VoxelChunk::channel_get_bits_per_voxel(const int channel_index) const {
+	_channels_ensure_resident();
+
+	ERR_FAIL_INDEX_V(channel_index, _channels.size(), 0);
+
+	const VoxelChannel &ch = _channels[channel_index];
+
+	if (ch.data == NULL && ch.packed == NULL)
+		return 0;
+
+	return ch.bits_per_voxel;
+}
+int64_t VoxelChunk::get_memory_usage() const {
+	return _memory_usage.get();
+}
+
+bool VoxelChunk::channels_evict() {
+	_THREAD_SAFE_METHOD_
+
+	if (_evicted || _snapshot_active || _is_generating)
+		return false;
+
+	_evicted_channels.resize(_channels.size());
+
+	for (int i = 0; i < _channels.size(); ++i) {
+		const VoxelChannel &ch = _channels[i];
+
+		//Uniform channels don't have buffers, and mapped ones can't be freed
+		if ((ch.data == NULL && ch.packed == NULL && ch.data_high == NULL) || ch.read_only)
+			continue;
+
+		PoolByteArray compressed = channel_get_compressed(i);
+		_memory_usage_add(compressed.size());
+
+		_evicted_channels.set(i, compressed);
+		_channel_free(i);
+	}
+
+	_evicted = true;
+
+	return true;
+}
+bool VoxelChunk::channels_drop() {
+	_THREAD_SAFE_METHOD_
+
+	//Edits would be lost, and generating the data needs the world
+	if (_evicted || _snapshot_active || _is_generating || !_voxel_world || !_edit_tracking || get_modified())
+		return false;
+
+	for (int i = 0; i < _channels.size(); ++i) {
+		if (!_channels[i].read_only)
+			_channel_free(i);
+	}
+
+	_evicted = true;
+	_evicted_regenerate = true;
+
+	return true;
+}
+void VoxelChunk::channels_restore() {
+	if (!_evicted)
+		return;
+
+	//Generation runs script callbacks, so it's done outside of the lock, and only on the main thread.
+	//Until then the data stays dropped.
+	if (_evicted_regenerate) {
+		ERR_FAIL_COND_MSG(!_voxel_world, "Error, dropped voxel data can only be generated again while the chunk is in a world!");
+		ERR_FAIL_COND_MSG(Thread::get_caller_id() != Thread::get_main_id(), "Error, dropped voxel data can only be generated again on the main thread!");
+
+		_evicted = false;
+		_evicted_regenerate = false;
+
+		//Same data as before, the mesh doesn't need to be built again
+		_voxel_world->chunk_generate_data(Ref<VoxelChunk>(this));
+
+		return;
+	}
+
+	_THREAD_SAFE_METHOD_
+
+	if (!_evicted)
+		return;
+
+	_evicted = false;
+
+	//Restoring doesn't modify anything
+	bool modified_full = _modified_full;
+
+	for (int i = 0; i < _evicted_channels.size() && i < _channels.size(); ++i) {
+		if (_evicted_channels[i].size() == 0)
+			continue;
+
+		channel_set_compressed(i, _evicted_channels[i]);
+		_memory_usage_sub(_evicted_channels[i].size());
+
+		if (_channel_packing)
+			channel_pack(i);
+		else
+			channel_collapse(i);
+
+		_channel_high_collapse(i);
+	}
+
+	_modified_full = modified_full;
+
+	_evicted_channels.clear();
+}
+bool VoxelChunk::channels_is_evicted() const {
+	return _evicted;
+}
+
+void VoxelChunk::memory_usage_attach(SafeNumeric<uint64_t> *counter) {
+	_THREAD_SAFE_METHOD_
+
+	if (_memory_usage_counter)
+		_memory_usage_counter->sub(_memory_usage.get());
+
+	_memory_usage_counter = counter;
+
+	if (_memory_usage_counter)
+		_memory_usage_counter->add(_memory_usage.get());
+}
+
+bool VoxelChunk::get_edit_tracking() const {
+	return _edit_tracking;
+}
+void VoxelChunk::set_edit_tracking(const bool value) {
+	_edit_tracking = value;
+
+	//The data is the baseline from now on, without tracking it's unknown
+	_modified_full = !value;
+	_modified_count = 0;
+	_modified_bits.clear();
+}
+
+bool VoxelChunk::get_modified() const {
+	return _modified_full || _modified_count > 0;
+}
+void VoxelChunk::set_modified(const bool value) {
+	_modified_full = value;
+	_modified_count = 0;
+	_modified_bits.clear();
+}
+bool VoxelChunk::get_modified_full() const {
+	return _modified_full;
+}
+int VoxelChunk::modified_get_count() const {
+	return _modified_count;
+}
+
+PoolIntArray VoxelChunk::modified_get_indices() const {
+	PoolIntArray arr;
+
+	if (_modified_count == 0)
+		return arr;
+
+	arr.resize(_modified_count);
+
+#if !GODOT4
+	PoolIntArray::Write w = arr.write();
+	int *dst = w.ptr();
+#else
+	int *dst = arr.ptrw();
+#endif
+
+	int n = 0;
+
+	for (int i = 0; i < _modified_bits.size(); ++i) {
+		uint32_t word = _modified_bits[i];
+
+		while (word) {
+			int bit = 0;
+
+			while (!(word & (1u << bit)))
+				++bit;
+
+			dst[n++] = (i << 5) + bit;
+			word &= word - 1;
+		}
+	}
+
+	return arr;
+}
+
+void VoxelChunk::snapshot_create() {
+	_channels_ensure_resident();
+
+	_THREAD_SAFE_METHOD_
+
+	if (_snapshot_active)
+		snapshot_release();
+
+	//Element wise copy, so the two vectors never share (and copy on write) their storage between threads
+	_snapshot_channels.resize(_channels.size());
+	_snapshot_decoded.resize(_channels.size());
+
+	for (int i = 0; i < _channels.size(); ++i) {
+		_channels.write[i].shared = true;
+
+		_snapshot_channels.write[i] = _channels[i];
+		_snapshot_decoded.write[i] = NULL;
+	}
+
+	_snapshot_data_size = get_data_size();
+
+	_snapshot_active = true;
+}
+void VoxelChunk::snapshot_release() {
 	_THREAD_SAFE_METHOD_
 
-	++_current_job;
-
-	if (_current_job >= _jobs.size()) {
-		_current_job = -1;
-		set_is_generating(false);
-		finalize_build();
+	if (!_snapshot_active)
 		return;
-	}
 
-	Ref<VoxelJob> j = _jobs[_current_job];
+	for (int i = 0; i < _snapshot_channels.size(); ++i) {
+		const VoxelChannel &sch = _snapshot_channels[i];
 
-	if (!j.is_valid()) {
-		//skip if invalid
-		job_next();
-	}
+		if (_snapshot_decoded[i])
+			_channel_buffer_free(_snapshot_decoded[i], _snapshot_data_size);
 
-	j->reset();
-	j->set_complete(false);
+		//Buffers that are still shared stay with the chunk, the rest were cloned, or dropped since
+		const VoxelChannel *ch = i < _channels.size() ? &_channels[i] : NULL;
 
-	if (j->get_build_phase_type() == VoxelJob::BUILD_PHASE_TYPE_NORMAL) {
-#if THREAD_POOL_PRESENT
-		ThreadPool::get_singleton()->add_job(j);
-#else
-		j->execute();
-#endif
-	}
-}
-Ref<VoxelJob> VoxelChunk::job_get_current() {
-	_THREAD_SAFE_METHOD_
+		if (sch.data && !sch.read_only && (!ch || ch->data != sch.data))
+			_channel_buffer_free(sch.data, _snapshot_data_size);
 
-	if (_current_job < 0 || _current_job >= _jobs.size()) {
-		return Ref<VoxelJob>();
+		if (sch.packed && (!ch || ch->packed != sch.packed))
+			_channel_buffer_free(sch.packed, (_snapshot_data_size * sch.bits_per_voxel + 7) >> 3);
+
+		if (sch.data_high && !sch.read_only && (!ch || ch->data_high != sch.data_high))
+			_channel_buffer_free(sch.data_high, _snapshot_data_size);
+
+		//Mapped channels still need to be copied before writes
+		if (ch)
+			_channels.write[i].shared = ch->read_only;
 	}
 
-	return _jobs[_current_job];
+	_snapshot_channels.clear();
+	_snapshot_decoded.clear();
+	_snapshot_active = false;
+}
+bool VoxelChunk::snapshot_is_active() const {
+	return _snapshot_active;
 }
 
-//Voxel Data
-void VoxelChunk::channel_setup() {
-	ERR_FAIL_COND_MSG(!has_method("_channel_setup"), "VoxelChunk: _setup_channels() is missing! Please implement it!");
+uint8_t *VoxelChunk::channel_get_snapshot(const int channel_index) {
+	_channels_ensure_resident();
 
-	call("_channel_setup");
-}
+	if (!_snapshot_active)
+		return channel_get(channel_index);
 
-void VoxelChunk::set_size(const int size_x, const int size_y, const int size_z, const int margin_start, const int margin_end) {
-	if (_size_x == size_x && _size_y == size_y && _size_z == size_z && _margin_start == margin_start && _margin_end == margin_end) {
-		return;
-	}
+	ERR_FAIL_INDEX_V(channel_index, _snapshot_channels.size(), NULL);
 
-	for (int i = 0; i < _channels.size(); ++i) {
-		uint8_t *ch = _channels[i];
+	const VoxelChannel &sch = _snapshot_channels[channel_index];
 
-		if (ch != NULL) {
-			memdelete_arr(ch);
-		}
-	}
+	if (sch.data)
+		return sch.data;
 
-	channel_setup();
+	if (!sch.packed && sch.bits_per_voxel != 0)
+		return NULL;
 
-	_size_x = size_x;
-	_size_y = size_y;
-	_size_z = size_z;
+	//Packed, and uniform channels are decoded once per snapshot
+	if (!_snapshot_decoded[channel_index]) {
+		uint8_t *decoded = _channel_buffer_alloc(_snapshot_data_size);
+		_channel_decode(sch, decoded);
 
-	_data_size_x = size_x + margin_start + margin_end;
-	_data_size_y = size_y + margin_start + margin_end;
-	_data_size_z = size_z + margin_start + margin_end;
+		_snapshot_decoded.write[channel_index] = decoded;
+	}
 
-	_margin_start = margin_start;
-	_margin_end = margin_end;
+	return _snapshot_decoded[channel_index];
 }
+uint8_t *VoxelChunk::channel_get_high_snapshot(const int channel_index) {
+	_channels_ensure_resident();
 
-bool VoxelChunk::validate_data_position(const int x, const int y, const int z) const {
-	return x < _data_size_x && y < _data_size_y && z < _data_size_z;
+	if (!_snapshot_active)
+		return channel_get_high(channel_index);
+
+	ERR_FAIL_INDEX_V(channel_index, _snapshot_channels.size(), NULL);
+
+	return _snapshot_channels[channel_index].data_high;
 }
+uint8_t VoxelChunk::get_voxel_snapshot(const int p_x, const int p_y, const int p_z, const int p_channel_index) const {
+	_channels_ensure_resident();
+
+	if (!_snapshot_active)
+		return get_voxel(p_x, p_y, p_z, p_channel_index);
 
-uint8_t VoxelChunk::get_voxel(const int p_x, const int p_y, const int p_z, const int p_channel_index) const {
 	int x = p_x + _margin_start;
 	int y = p_y + _margin_start;
 	int z = p_z + _margin_start;
 
-	ERR_FAIL_INDEX_V(p_channel_index, _channels.size(), 0);
+	ERR_FAIL_INDEX_V(p_channel_index, _snapshot_channels.size(), 0);
 	ERR_FAIL_COND_V_MSG(!validate_data_position(x, y, z), 0, "Error, index out of range! " + String::num(x) + " " + String::num(y) + " " + String::num(z));
 
-	uint8_t *ch = _channels.get(p_channel_index);
+	return get_voxel_snapshot_unchecked(p_x, p_y, p_z, p_channel_index);
+}
 
-	if (!ch)
-		return 0;
+bool VoxelChunk::channel_is_uniform_snapshot(const int channel_index) const {
+	if (!_snapshot_active)
+		return channel_is_uniform(channel_index);
 
-	return ch[get_data_index(x, y, z)];
-}
-void VoxelChunk::set_voxel(const uint8_t p_value, const int p_x, const int p_y, const int p_z, const int p_channel_index) {
-	int x = p_x + _margin_start;
-	int y = p_y + _margin_start;
-	int z = p_z + _margin_start;
+	ERR_FAIL_INDEX_V(channel_index, _snapshot_channels.size(), false);
 
-	ERR_FAIL_INDEX(p_channel_index, _channels.size());
-	ERR_FAIL_COND_MSG(!validate_data_position(x, y, z), "Error, index out of range! " + String::num(x) + " " + String::num(y) + " " + String::num(z));
+	const VoxelChannel &sch = _snapshot_channels[channel_index];
 
-	uint8_t *ch = channel_get_valid(p_channel_index);
+	return sch.data == NULL && sch.packed == NULL && sch.data_high == NULL;
+}
 
-	ch[get_data_index(x, y, z)] = p_value;
+uint32_t VoxelChunk::_channel_get_packed_size(const int bits_per_voxel) const {
+	return (static_cast<uint32_t>(get_data_size()) * bits_per_voxel + 7) >> 3;
 }
 
-int VoxelChunk::channel_get_count() const {
-	return _channels.size();
+int VoxelChunk::_channel_palette_get_or_add(VoxelChannel &ch, const uint8_t value) {
+	for (int i = 0; i < ch.palette_size; ++i) {
+		if (ch.palette[i] == value)
+			return i;
+	}
+
+	if (ch.palette_size == CHANNEL_PALETTE_MAX_SIZE)
+		return -1;
+
+	if (ch.palette_size == (1 << ch.bits_per_voxel))
+		_channel_repack(ch, ch.bits_per_voxel * 2);
+
+	ch.palette[ch.palette_size] = value;
+
+	return ch.palette_size++;
 }
 
-void VoxelChunk::channel_set_count(const int count) {
-	if (count == _channels.size())
-		return;
+void VoxelChunk::_channel_repack(VoxelChannel &ch, const int bits_per_voxel) {
+	uint32_t size = get_data_size();
+	uint32_t packed_size = _channel_get_packed_size(bits_per_voxel);
 
-	if (_channels.size() >= count) {
-		for (int i = count; i < _channels.size(); ++i) {
-			uint8_t *ch = _channels[i];
+	VoxelChannel nch = ch;
+	nch.bits_per_voxel = bits_per_voxel;
+	nch.packed = _channel_buffer_alloc(packed_size);
+	memset(nch.packed, 0, packed_size);
 
-			if (ch != NULL) {
-				memdelete_arr(ch);
-			}
-		}
+	int mask = (1 << ch.bits_per_voxel) - 1;
 
-		_channels.resize(count);
-		return;
+	for (uint32_t i = 0; i < size; ++i) {
+		uint32_t bit = i * ch.bits_per_voxel;
+
+		_channel_packed_set_index(nch, i, (ch.packed[bit >> 3] >> (bit & 7)) & mask);
 	}
 
-	int s = _channels.size();
-	_channels.resize(count);
+	_channel_buffer_free(ch.packed, _channel_get_packed_size(ch.bits_per_voxel));
 
-	for (int i = s; i < count; ++i) {
-		_channels.set(i, NULL);
-	}
+	ch.packed = nch.packed;
+	ch.bits_per_voxel = bits_per_voxel;
 }
-bool VoxelChunk::channel_is_allocated(const int channel_index) {
-	ERR_FAIL_INDEX_V(channel_index, _channels.size(), false);
 
-	return _channels[channel_index] != NULL;
-}
-void VoxelChunk::channel_ensure_allocated(const int channel_index, const uint8_t default_value) {
-	ERR_FAIL_INDEX(channel_index, _channels.size());
+void VoxelChunk::_channel_decode(const VoxelChannel &ch, uint8_t *dst) const {
+	uint32_t size = get_data_size();
 
-	if (_channels[channel_index] == NULL)
-		channel_allocate(channel_index, default_value);
+	if (ch.data) {
+		memcpy(dst, ch.data, size);
+		return;
+	}
+
+	if (!ch.packed) {
+		memset(dst, ch.palette[0], size);
+		return;
+	}
+
+	for (uint32_t i = 0; i < size; ++i) {
+		dst[i] = _channel_packed_get(ch, i);
+	}
 }
-void VoxelChunk::channel_allocate(const int channel_index, const uint8_t default_value) {
-	ERR_FAIL_INDEX(channel_index, _channels.size());
 
-	if (_channels[channel_index] != NULL)
+void VoxelChunk::_modified_mark(const int x, const int y, const int z) {
+	if (_modified_full)
 		return;
 
-	uint32_t size = _data_size_x * _data_size_y * _data_size_z;
+	uint32_t index = x + _data_size_x * (y + _data_size_y * z);
 
-	uint8_t *ch = memnew_arr(uint8_t, size);
-	memset(ch, default_value, size);
+	if (_modified_bits.size() == 0) {
+		_modified_bits.resize((_data_size_x * _data_size_y * _data_size_z + 31) / 32);
+
+		uint32_t *bits = _modified_bits.ptrw();
+
+		for (int i = 0; i < _modified_bits.size(); ++i)
+			bits[i] = 0;
+	}
 
-	_channels.set(channel_index, ch);
+	uint32_t *word = _modified_bits.ptrw() + (index >> 5);
+	uint32_t mask = 1u << (index & 31);
+
+	if (!(*word & mask)) {
+		*word |= mask;
+		++_modified_count;
+	}
 }
-void VoxelChunk::channel_fill(const uint8_t value, const int channel_index) {
-	ERR_FAIL_INDEX(channel_index, _channels.size());
 
-	uint8_t *ch = _channels.get(channel_index);
+void VoxelChunk::_channel_free(const int channel_index) {
+	//Shared buffers belong to the snapshot until it's released
+	if (_channels[channel_index].shared)
+		_channel_detach(channel_index, false);
 
-	if (ch == NULL) {
-		channel_allocate(channel_index, value);
-		return;
+	VoxelChannel &ch = _channels.write[channel_index];
+
+	if (ch.data != NULL) {
+		_channel_buffer_free(ch.data, get_data_size());
+		ch.data = NULL;
 	}
 
-	uint32_t size = get_data_size();
+	if (ch.packed != NULL) {
+		_channel_buffer_free(ch.packed, _channel_get_packed_size(ch.bits_per_voxel));
+		ch.packed = NULL;
+	}
 
-	for (uint32_t i = 0; i < size; ++i) {
-		ch[i] = value;
+	if (ch.data_high != NULL) {
+		_channel_buffer_free(ch.data_high, get_data_size());
+		ch.data_high = NULL;
 	}
+
+	ch.bits_per_voxel = 8;
+	ch.palette_size = 0;
+	ch.palette[0] = 0;
 }
-void VoxelChunk::channel_dealloc(const int channel_index) {
-	ERR_FAIL_INDEX(channel_index, _channels.size());
 
-	uint8_t *ch = _channels.get(channel_index);
+uint8_t *VoxelChunk::_channel_buffer_alloc(const uint32_t size) const {
+	_memory_usage_add(size);
+
+	if (_buffer_pool.is_valid())
+		return _buffer_pool->buffer_alloc(size);
+
+	return memnew_arr(uint8_t, size);
+}
 
-	if (ch != NULL) {
-		memdelete_arr(ch);
+void VoxelChunk::_channel_buffer_free(uint8_t *buffer, const uint32_t size) const {
+	_memory_usage_sub(size);
 
-		_channels.set(channel_index, NULL);
+	if (_buffer_pool.is_valid()) {
+		_buffer_pool->buffer_free(buffer, size);
+		return;
 	}
+
+	memdelete_arr(buffer);
 }
 
-uint8_t *VoxelChunk::channel_get(const int channel_index) {
-	ERR_FAIL_INDEX_V(channel_index, _channels.size(), NULL);
+//Builds allocate on worker threads, both counters are atomic
+void VoxelChunk::_memory_usage_add(const uint64_t size) const {
+	_memory_usage.add(size);
 
-	return _channels.get(channel_index);
+	if (_memory_usage_counter)
+		_memory_usage_counter->add(size);
 }
-uint8_t *VoxelChunk::channel_get_valid(const int channel_index, const uint8_t default_value) {
-	ERR_FAIL_INDEX_V(channel_index, _channels.size(), 0);
+void VoxelChunk::_memory_usage_sub(const uint64_t size) const {
+	_memory_usage.sub(size);
 
-	uint8_t *ch = _channels.get(channel_index);
+	if (_memory_usage_counter)
+		_memory_usage_counter->sub(size);
+}
 
-	if (ch == NULL) {
-		channel_allocate(channel_index, default_value);
+void VoxelChunk::_channel_detach(const int channel_index, const bool keep_data) {
+	_THREAD_SAFE_METHOD_
 
-		return _channels.get(channel_index);
-	}
+	VoxelChannel &ch = _channels.write[channel_index];
 
-	return ch;
-}
+	if (!ch.shared)
+		return;
 
-PoolByteArray VoxelChunk::channel_get_array(const int channel_index) const {
-	PoolByteArray arr;
+	ch.shared = false;
 
-	uint32_t size = _data_size_x * _data_size_y * _data_size_z;
+	//Copy on write of mapped data, the snapshot (if any) keeps referencing the mapping
+	if (ch.read_only) {
+		ch.read_only = false;
 
-	if (channel_index >= _channels.size())
-		return arr;
+		uint32_t size = get_data_size();
 
-	uint8_t *ch = _channels.get(channel_index);
+		if (ch.data) {
+			uint8_t *mapped = ch.data;
+			ch.data = NULL;
 
-	if (ch == NULL)
-		return arr;
+			if (keep_data) {
+				ch.data = _channel_buffer_alloc(size);
+				memcpy(ch.data, mapped, size);
+			}
+		}
 
-	arr.resize(size);
+		if (ch.data_high) {
+			uint8_t *mapped = ch.data_high;
+			ch.data_high = NULL;
 
-	for (uint32_t i = 0; i < size; ++i) {
-		arr.set(i, ch[i]);
+			if (keep_data) {
+				ch.data_high = _channel_buffer_alloc(size);
+				memcpy(ch.data_high, mapped, size);
+			}
+		}
+
+		return;
 	}
 
-	return arr;
-}
-void VoxelChunk::channel_set_array(const int channel_index, const PoolByteArray &array) {
-	if (array.size() == 0)
+	if (!_snapshot_active || channel_index >= _snapshot_channels.size())
 		return;
 
-	if (_channels.size() <= channel_index)
-		channel_set_count(channel_index + 1);
+	const VoxelChannel &sch = _snapshot_channels[channel_index];
 
-	uint8_t *ch = _channels.get(channel_index);
+	if (ch.data && ch.data == sch.data) {
+		if (keep_data) {
+			ch.data = _channel_buffer_alloc(get_data_size());
+			memcpy(ch.data, sch.data, get_data_size());
+		} else {
+			ch.data = NULL;
+		}
+	}
 
-	if (ch == NULL) {
-		if (_channels[channel_index] != NULL)
-			return;
+	if (ch.packed && ch.packed == sch.packed) {
+		uint32_t packed_size = _channel_get_packed_size(ch.bits_per_voxel);
 
-		ch = memnew_arr(uint8_t, array.size());
-		_channels.set(channel_index, ch);
+		if (keep_data) {
+			ch.packed = _channel_buffer_alloc(packed_size);
+			memcpy(ch.packed, sch.packed, packed_size);
+		} else {
+			ch.packed = NULL;
+		}
 	}
 
-	for (int i = 0; i < array.size(); ++i) {
-		ch[i] = array[i];
+	if (ch.data_high && ch.data_high == sch.data_high) {
+		if (keep_data) {
+			ch.data_high = _channel_buffer_alloc(get_data_size());
+			memcpy(ch.data_high, sch.data_high, get_data_size());
+		} else {
+			ch.data_high = NULL;
+		}
 	}
 }
 
-PoolByteArray VoxelChunk::channel_get_compressed(const int channel_index) const {
-	PoolByteArray arr;
+void VoxelChunk::_channel_high_collapse(const int channel_index) {
+	const VoxelChannel &ch = _channels[channel_index];
 
-	int size = _data_size_x * _data_size_y * _data_size_z;
+	if (!ch.data_high || ch.shared)
+		return;
 
-	if (channel_index >= _channels.size())
-		return arr;
+	uint32_t size = get_data_size();
 
-	uint8_t *ch = _channels.get(channel_index);
+	for (uint32_t i = 0; i < size; ++i) {
+		if (ch.data_high[i] != 0)
+			return;
+	}
 
-	if (ch == NULL)
-		return arr;
+	_channel_buffer_free(ch.data_high, size);
+	_channels.write[channel_index].data_high = NULL;
+}
 
-	int bound = LZ4_compressBound(size);
-	arr.resize(bound);
+void VoxelChunk::_channel_set_uniform(VoxelChannel &ch, const uint8_t value) {
+	ch.bits_per_voxel = 0;
+	ch.palette_size = 1;
+	ch.palette[0] = value;
+}
 
-#if !GODOT4
-	PoolByteArray::Write w = arr.write();
+void VoxelChunk::_data_layout_build_tables(const int layout, Vector<uint32_t> &index_x, Vector<uint32_t> &index_y, Vector<uint32_t> &index_z, uint32_t &capacity) const {
+	int size_x = _data_size_x;
+	int size_y = _data_size_y;
+	int size_z = _data_size_z;
 
-	int ns = LZ4_compress_default(reinterpret_cast<char *>(ch), reinterpret_cast<char *>(w.ptr()), size, bound);
+	int brick_size = 1;
 
-	w.release();
-#else
-	int ns = LZ4_compress_default(reinterpret_cast<char *>(ch), reinterpret_cast<char *>(arr.ptrw()), size, bound);
-#endif
-	arr.resize(ns);
+	if (layout == DATA_LAYOUT_BRICK_4) {
+		brick_size = 4;
+	} else if (layout == DATA_LAYOUT_BRICK_8) {
+		brick_size = 8;
+	}
 
-	return arr;
-}
-void VoxelChunk::channel_set_compressed(const int channel_index, const PoolByteArray &data) {
-	if (data.size() == 0)
-		return;
+	//Bricks and morton codes need the data to be padded
+	if (brick_size > 1) {
+		size_x = ((size_x + brick_size - 1) / brick_size) * brick_size;
+		size_y = ((size_y + brick_size - 1) / brick_size) * brick_size;
+		size_z = ((size_z + brick_size - 1) / brick_size) * brick_size;
+	} else if (layout == DATA_LAYOUT_MORTON) {
+		size_x = size_x > 0 ? next_power_of_2(size_x) : 0;
+		size_y = size_y > 0 ? next_power_of_2(size_y) : 0;
+		size_z = size_z > 0 ? next_power_of_2(size_z) : 0;
+	}
 
-	int size = _data_size_x * _data_size_y * _data_size_z;
+	index_x.resize(size_x);
+	index_y.resize(size_y);
+	index_z.resize(size_z);
 
-	if (_channels.size() <= channel_index)
-		channel_set_count(channel_index + 1);
+	capacity = size_x * size_y * size_z;
 
-	uint8_t *ch = _channels.get(channel_index);
+	uint32_t *ix = index_x.ptrw();
+	uint32_t *iy = index_y.ptrw();
+	uint32_t *iz = index_z.ptrw();
 
-	if (ch == NULL) {
-		if (_channels[channel_index] != NULL)
-			return;
+	if (layout == DATA_LAYOUT_MORTON) {
+		for (int i = 0; i < size_x; ++i)
+			ix[i] = 0;
 
-		ch = memnew_arr(uint8_t, size);
-		_channels.set(channel_index, ch);
-	}
+		for (int i = 0; i < size_y; ++i)
+			iy[i] = 0;
 
-	int ds = data.size();
+		for (int i = 0; i < size_z; ++i)
+			iz[i] = 0;
 
-#if !GODOT4
-	PoolByteArray::Read r = data.read();
+		//Interleave the bits of the coordinates (y first), axes that run out of bits are skipped
+		int bit = 0;
 
-	//We are not going to write to it
-	uint8_t *data_arr = const_cast<uint8_t *>(r.ptr());
+		for (int b = 0; (1 << b) < size_x || (1 << b) < size_y || (1 << b) < size_z; ++b) {
+			if ((1 << b) < size_y) {
+				for (int i = 0; i < size_y; ++i)
+					iy[i] |= ((i >> b) & 1) << bit;
 
-	LZ4_decompress_safe(reinterpret_cast<char *>(data_arr), reinterpret_cast<char *>(ch), ds, size);
-#else
-	//We are not going to write to it
-	uint8_t *data_arr = const_cast<uint8_t *>(data.ptr());
+				++bit;
+			}
 
-	LZ4_decompress_safe(reinterpret_cast<char *>(data_arr), reinterpret_cast<char *>(ch), ds, size);
-#endif
-}
+			if ((1 << b) < size_x) {
+				for (int i = 0; i < size_x; ++i)
+					ix[i] |= ((i >> b) & 1) << bit;
 
-_FORCE_INLINE_ int VoxelChunk::get_index(const int x, const int y, const int z) const {
-	return (y + _margin_start) + _data_size_y * ((x + _margin_start) + _data_size_x * (z + _margin_start));
-}
+				++bit;
+			}
+
+			if ((1 << b) < size_z) {
+				for (int i = 0; i < size_z; ++i)
+					iz[i] |= ((i >> b) & 1) << bit;
+
+				++bit;
+			}
+		}
+
+		return;
+	}
+
+	//Linear is the same as bricks with a brick size of 1
+	int brick_volume = brick_size * brick_size * brick_size;
+	int bricks_x = size_x / brick_size;
+	int bricks_y = size_y / brick_size;
+
+	for (int i = 0; i < size_y; ++i)
+		iy[i] = (i / brick_size) * brick_volume + (i % brick_size);
 
-_FORCE_INLINE_ int VoxelChunk::get_data_index(const int x, const int y, const int z) const {
-	return y + _data_size_y * (x + _data_size_x * z);
+	for (int i = 0; i < size_x; ++i)
+		ix[i] = (i / brick_size) * bricks_y * brick_volume + (i % brick_size) * brick_size;
+
+	for (int i = 0; i < size_z; ++i)
+		iz[i] = (i / brick_size) * bricks_y * bricks_x * brick_volume + (i % brick_size) * brick_size * brick_size;
 }
 
-_FORCE_INLINE_ int VoxelChunk::get_data_size() const {
-	return _data_size_x * _data_size_y * _data_size_z;
+void VoxelChunk::_channel_fill_padding(uint8_t *data) const {
+	if (_data_layout == DATA_LAYOUT_LINEAR || _data_capacity == 0)
+		return;
+
+	//Padding never gets written, make it match the data so scans see one value less
+	uint8_t value = data[get_data_index(0, 0, 0)];
+
+	const uint32_t *ix = _data_index_x.ptr();
+	const uint32_t *iy = _data_index_y.ptr();
+	const uint32_t *iz = _data_index_z.ptr();
+
+	for (int z = 0; z < _data_index_z.size(); ++z) {
+		for (int x = 0; x < _data_index_x.size(); ++x) {
+			int y = (z < _data_size_z && x < _data_size_x) ? _data_size_y : 0;
+
+			for (; y < _data_index_y.size(); ++y) {
+				data[ix[x] + iy[y] + iz[z]] = value;
+			}
+		}
+	}
 }
 
 //Voxel Structures
@@ -634,7 +2582,13 @@ void VoxelChunk::_build() {
 		return;
 	}
 
-	_is_generating = true;
+	//The previous build finished, but the world didn't get to it yet
+	finalize_build_channels();
+
+	set_is_generating(true);
+
+	//Jobs read this, edits made while the build runs will clone the channels they touch
+	snapshot_create();
 
 	job_next();
 }
@@ -998,7 +2952,8 @@ Vector3 VoxelChunk::to_global(Vector3 p_local) const {
 	return get_global_transform().xform(p_local);
 }
 
-VoxelChunk::VoxelChunk() {
+VoxelChunk::VoxelChunk() :
+		_lru_item(this) {
 	_is_build_threaded = false;
 	_is_processing = false;
 	_is_phisics_processing = false;
@@ -1013,6 +2968,12 @@ VoxelChunk::VoxelChunk() {
 	_voxel_scale = 1;
 
 	_voxel_world = NULL;
+	_world_index = -1;
+	_active_lists = 0;
+
+	for (int i = 0; i < ACTIVE_LIST_INDEX_COUNT; ++i) {
+		_active_list_indices[i] = -1;
+	}
 
 	_position_x = 0;
 	_position_y = 0;
@@ -1029,9 +2990,26 @@ VoxelChunk::VoxelChunk() {
 	_margin_start = 0;
 	_margin_end = 0;
 
+	_data_layout = DATA_LAYOUT_LINEAR;
+	_data_capacity = 0;
+
 	_current_job = -1;
 
 	_queued_generation = false;
+	_build_channels_pending = false;
+
+	_channel_packing = true;
+
+	_snapshot_active = false;
+	_snapshot_data_size = 0;
+
+	_evicted = false;
+	_evicted_regenerate = false;
+	_memory_usage_counter = NULL;
+
+	_edit_tracking = false;
+	_modified_full = true;
+	_modified_count = 0;
 }
 
 VoxelChunk::~VoxelChunk() {
@@ -1047,14 +3025,14 @@ VoxelChunk::~VoxelChunk() {
 	mesh_data_resource_clear();
 #endif
 
-	for (int i = 0; i < _channels.size(); ++i) {
-		uint8_t *ch = _channels[i];
+	snapshot_release();
 
-		if (ch != NULL) {
-			memdelete_arr(ch);
-		}
+	for (int i = 0; i < _channels.size(); ++i) {
+		_channel_free(i);
 	}
 
+	_buffer_pool.unref();
+
 	for (int i = 0; i < _colliders.size(); ++i) {
 		PhysicsServer::get_singleton()->free(_colliders[i].body);
 	}
@@ -1102,13 +3080,8 @@ void VoxelChunk::_generation_process(const float delta) {
 
 		job->process(delta);
 
-		if (job->get_build_phase_type() == VoxelJob::BUILD_PHASE_TYPE_NORMAL) {
-#if THREAD_POOL_PRESENT
-			ThreadPool::get_singleton()->add_job(job);
-#else
-			job->execute();
-#endif
-		}
+		if (job->get_build_phase_type() == VoxelJob::BUILD_PHASE_TYPE_NORMAL)
+			_job_submit(job);
 	}
 }
 void VoxelChunk::_generation_physics_process(const float delta) {
@@ -1127,13 +3100,8 @@ void VoxelChunk::_generation_physics_process(const float delta) {
 
 		job->physics_process(delta);
 
-		if (job->get_build_phase_type() == VoxelJob::BUILD_PHASE_TYPE_NORMAL) {
-#if THREAD_POOL_PRESENT
-			ThreadPool::get_singleton()->add_job(job);
-#else
-			job->execute();
-#endif
-		}
+		if (job->get_build_phase_type() == VoxelJob::BUILD_PHASE_TYPE_NORMAL)
+			_job_submit(job);
 	}
 }
 
@@ -1318,6 +3286,10 @@ void VoxelChunk::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_margin_end"), &VoxelChunk::set_margin_end);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "margin_end"), "set_margin_end", "get_margin_end");
 
+	ClassDB::bind_method(D_METHOD("get_data_layout"), &VoxelChunk::get_data_layout);
+	ClassDB::bind_method(D_METHOD("set_data_layout", "value"), &VoxelChunk::set_data_layout);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "data_layout", PROPERTY_HINT_ENUM, BINDING_STRING_DATA_LAYOUT), "set_data_layout", "get_data_layout");
+
 	ClassDB::bind_method(D_METHOD("get_library"), &VoxelChunk::get_library);
 	ClassDB::bind_method(D_METHOD("set_library", "value"), &VoxelChunk::set_library);
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "library", PROPERTY_HINT_RESOURCE_TYPE, "VoxelmanLibrary"), "set_library", "get_library");
@@ -1335,6 +3307,7 @@ void VoxelChunk::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("job_get_current_index"), &VoxelChunk::job_get_current_index);
 	ClassDB::bind_method(D_METHOD("job_next"), &VoxelChunk::job_next);
 	ClassDB::bind_method(D_METHOD("job_get_current"), &VoxelChunk::job_get_current);
+	ClassDB::bind_method(D_METHOD("finalize_build_channels"), &VoxelChunk::finalize_build_channels);
 
 	ClassDB::bind_method(D_METHOD("get_voxel_world"), &VoxelChunk::get_voxel_world);
 	ClassDB::bind_method(D_METHOD("set_voxel_world", "world"), &VoxelChunk::set_voxel_world_bind);
@@ -1350,6 +3323,14 @@ void VoxelChunk::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_voxel", "x", "y", "z", "index"), &VoxelChunk::get_voxel);
 	ClassDB::bind_method(D_METHOD("set_voxel", "value", "x", "y", "z", "index"), &VoxelChunk::set_voxel);
 
+	ClassDB::bind_method(D_METHOD("get_voxel16", "x", "y", "z", "index"), &VoxelChunk::get_voxel16);
+	ClassDB::bind_method(D_METHOD("set_voxel16", "value", "x", "y", "z", "index"), &VoxelChunk::set_voxel16);
+
+	ClassDB::bind_method(D_METHOD("channel_get_width", "channel_index"), &VoxelChunk::channel_get_width);
+	ClassDB::bind_method(D_METHOD("channel_set_width", "channel_index", "bits"), &VoxelChunk::channel_set_width);
+	ClassDB::bind_method(D_METHOD("channel_get_derived", "channel_index"), &VoxelChunk::channel_get_derived);
+	ClassDB::bind_method(D_METHOD("channel_set_derived", "channel_index", "value"), &VoxelChunk::channel_set_derived);
+
 	ClassDB::bind_method(D_METHOD("channel_get_count"), &VoxelChunk::channel_get_count);
 	ClassDB::bind_method(D_METHOD("channel_set_count", "count"), &VoxelChunk::channel_set_count);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "channel_count"), "channel_set_count", "channel_get_count");
@@ -1366,10 +3347,55 @@ void VoxelChunk::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("channel_get_compressed", "index"), &VoxelChunk::channel_get_compressed);
 	ClassDB::bind_method(D_METHOD("channel_set_compressed", "index", "array"), &VoxelChunk::channel_set_compressed);
 
+	ClassDB::bind_method(D_METHOD("data_serialize", "include_derived"), &VoxelChunk::data_serialize, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("data_deserialize", "data"), &VoxelChunk::data_deserialize);
+	ClassDB::bind_method(D_METHOD("data_get_compressed", "include_derived"), &VoxelChunk::data_get_compressed, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("data_set_compressed", "data"), &VoxelChunk::data_set_compressed);
+	ClassDB::bind_method(D_METHOD("channel_is_read_only", "index"), &VoxelChunk::channel_is_read_only);
+
+	ClassDB::bind_method(D_METHOD("get_channel_packing"), &VoxelChunk::get_channel_packing);
+	ClassDB::bind_method(D_METHOD("set_channel_packing", "value"), &VoxelChunk::set_channel_packing);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "channel_packing"), "set_channel_packing", "get_channel_packing");
+
+	ClassDB::bind_method(D_METHOD("get_buffer_pool"), &VoxelChunk::get_buffer_pool);
+	ClassDB::bind_method(D_METHOD("set_buffer_pool", "pool"), &VoxelChunk::set_buffer_pool);
+
+	ClassDB::bind_method(D_METHOD("channel_pack", "index"), &VoxelChunk::channel_pack);
+	ClassDB::bind_method(D_METHOD("channel_unpack", "index"), &VoxelChunk::channel_unpack);
+	ClassDB::bind_method(D_METHOD("channels_pack"), &VoxelChunk::channels_pack);
+	ClassDB::bind_method(D_METHOD("channel_is_packed", "index"), &VoxelChunk::channel_is_packed);
+	ClassDB::bind_method(D_METHOD("channel_is_uniform", "index"), &VoxelChunk::channel_is_uniform);
+	ClassDB::bind_method(D_METHOD("channel_is_uniform_snapshot", "index"), &VoxelChunk::channel_is_uniform_snapshot);
+	ClassDB::bind_method(D_METHOD("channel_collapse", "index"), &VoxelChunk::channel_collapse);
+	ClassDB::bind_method(D_METHOD("channel_get_bits_per_voxel", "index"), &VoxelChunk::channel_get_bits_per_voxel);
+	ClassDB::bind_method(D_METHOD("get_memory_usage"), &VoxelChunk::get_memory_usage);
+
+	ClassDB::bind_method(D_METHOD("channels_evict"), &VoxelChunk::channels_evict);
+	ClassDB::bind_method(D_METHOD("channels_drop"), &VoxelChunk::channels_drop);
+	ClassDB::bind_method(D_METHOD("channels_restore"), &VoxelChunk::channels_restore);
+	ClassDB::bind_method(D_METHOD("channels_is_evicted"), &VoxelChunk::channels_is_evicted);
+
+	ClassDB::bind_method(D_METHOD("get_edit_tracking"), &VoxelChunk::get_edit_tracking);
+	ClassDB::bind_method(D_METHOD("set_edit_tracking", "value"), &VoxelChunk::set_edit_tracking);
+	ClassDB::bind_method(D_METHOD("get_modified"), &VoxelChunk::get_modified);
+	ClassDB::bind_method(D_METHOD("set_modified", "value"), &VoxelChunk::set_modified);
+	ClassDB::bind_method(D_METHOD("get_modified_full"), &VoxelChunk::get_modified_full);
+	ClassDB::bind_method(D_METHOD("modified_get_count"), &VoxelChunk::modified_get_count);
+	ClassDB::bind_method(D_METHOD("modified_get_indices"), &VoxelChunk::modified_get_indices);
+
+	ClassDB::bind_method(D_METHOD("snapshot_create"), &VoxelChunk::snapshot_create);
+	ClassDB::bind_method(D_METHOD("snapshot_release"), &VoxelChunk::snapshot_release);
+	ClassDB::bind_method(D_METHOD("snapshot_is_active"), &VoxelChunk::snapshot_is_active);
+	ClassDB::bind_method(D_METHOD("get_voxel_snapshot", "x", "y", "z", "channel_index"), &VoxelChunk::get_voxel_snapshot);
+
 	ClassDB::bind_method(D_METHOD("get_index", "x", "y", "z"), &VoxelChunk::get_index);
 	ClassDB::bind_method(D_METHOD("get_data_index", "x", "y", "z"), &VoxelChunk::get_data_index);
 	ClassDB::bind_method(D_METHOD("get_data_size"), &VoxelChunk::get_data_size);
 
+	ClassDB::bind_method(D_METHOD("validate_region", "x", "y", "z", "size_x", "size_y", "size_z"), &VoxelChunk::validate_region);
+	ClassDB::bind_method(D_METHOD("copy_region_to", "region", "channels"), &VoxelChunk::copy_region_to_bind);
+	ClassDB::bind_method(D_METHOD("write_region_from", "buffer", "region", "channels"), &VoxelChunk::write_region_from_bind);
+
 	ClassDB::bind_method(D_METHOD("voxel_structure_get", "index"), &VoxelChunk::voxel_structure_get);
 	ClassDB::bind_method(D_METHOD("voxel_structure_add", "structure"), &VoxelChunk::voxel_structure_add);
 	ClassDB::bind_method(D_METHOD("voxel_structure_remove", "structure"), &VoxelChunk::voxel_structure_remove);
@@ -1451,4 +3477,10 @@ void VoxelChunk::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("_generation_process"), &VoxelChunk::_generation_process);
 	ClassDB::bind_method(D_METHOD("_generation_physics_process"), &VoxelChunk::_generation_physics_process);
+
+	BIND_ENUM_CONSTANT(DATA_LAYOUT_LINEAR);
+	BIND_ENUM_CONSTANT(DATA_LAYOUT_BRICK_4);
+	BIND_ENUM_CONSTANT(DATA_LAYOUT_BRICK_8);
+	BIND_ENUM_CONSTANT(DATA_LAYOUT_MORTON);
+	BIND_ENUM_CONSTANT(DATA_LAYOUT_MAX);
 }
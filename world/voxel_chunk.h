@@ -30,11 +30,15 @@ SOFTWARE.
 #include "core/string/ustring.h"
 #include "core/config/engine.h"
 #include "core/variant/array.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/self_list.h"
 #else
 #include "core/resource.h"
 #include "core/ustring.h"
 #include "core/engine.h"
 #include "core/array.h"
+#include "core/safe_refcount.h"
+#include "core/self_list.h"
 #endif
 
 #include "../defines.h"
@@ -48,6 +52,7 @@ include_pool_vector
 
 #include "scene/resources/packed_scene.h"
 
+#include "voxel_buffer_pool.h"
 #include "voxel_world.h"
 
 #include "../data/voxel_light.h"
@@ -82,6 +87,20 @@ public:
 		VOXEL_CHUNK_STATE_OK = 0,
 	};
 
+	enum {
+		ACTIVE_LIST_INDEX_COUNT = 4,
+	};
+
+	enum DataLayout {
+		DATA_LAYOUT_LINEAR = 0,
+		DATA_LAYOUT_BRICK_4,
+		DATA_LAYOUT_BRICK_8,
+		DATA_LAYOUT_MORTON,
+		DATA_LAYOUT_MAX,
+	};
+
+	static const String BINDING_STRING_DATA_LAYOUT;
+
 public:
 	bool get_is_build_threaded() const;
 	void set_is_build_threaded(const bool value);
@@ -141,6 +160,9 @@ public:
 	void set_margin_start(const int value);
 	void set_margin_end(const int value);
 
+	int get_data_layout() const;
+	void set_data_layout(const int layout);
+
 	Ref<VoxelmanLibrary> get_library();
 	void set_library(const Ref<VoxelmanLibrary> &value);
 
@@ -151,6 +173,18 @@ public:
 	void set_voxel_world(VoxelWorld *world);
 	void set_voxel_world_bind(Node *world);
 
+	//Index in the world's chunk list, only VoxelWorld should change it
+	int get_world_index() const;
+	void set_world_index(const int index);
+
+	//VoxelWorld::ActiveList flags, only VoxelWorld should change it
+	int get_active_lists() const;
+	void set_active_lists(const int lists);
+
+	//Where the chunk is in the world's process, physics process, generating, and dirty lists, so it can be swap removed
+	int get_active_list_index(const int list) const;
+	void set_active_list_index(const int list, const int index);
+
 	//Jobs
 	Ref<VoxelJob> job_get(const int index) const;
 	void job_set(const int index, const Ref<VoxelJob> &job);
@@ -162,6 +196,10 @@ public:
 	void job_next();
 	Ref<VoxelJob> job_get_current();
 
+	//The world calls this on the main thread when a build's last job finished.
+	//Releases the build's snapshot, then packs / collapses the channels.
+	void finalize_build_channels();
+
 	//Channels
 	void channel_setup();
 
@@ -172,6 +210,17 @@ public:
 	uint8_t get_voxel(const int p_x, const int p_y, const int p_z, const int p_index) const;
 	void set_voxel(const uint8_t p_value, const int p_x, const int p_y, const int p_z, const int p_index);
 
+	//16 bit channels. get_voxel() / set_voxel() keep working on them with the low byte.
+	uint16_t get_voxel16(const int p_x, const int p_y, const int p_z, const int p_index) const;
+	void set_voxel16(const uint16_t p_value, const int p_x, const int p_y, const int p_z, const int p_index);
+
+	int channel_get_width(const int channel_index) const;
+	void channel_set_width(const int channel_index, const int bits);
+
+	//Derived channels (like light, and ao) are recalculated by every build, edit tracking, and persistence ignores them.
+	bool channel_get_derived(const int channel_index) const;
+	void channel_set_derived(const int channel_index, const bool value);
+
 	int channel_get_count() const;
 	void channel_set_count(const int count);
 
@@ -184,15 +233,195 @@ public:
 	uint8_t *channel_get(const int channel_index);
 	uint8_t *channel_get_valid(const int channel_index, const uint8_t default_value = 0);
 
+	//High bytes of a 16 bit channel, NULL if they are all 0
+	uint8_t *channel_get_high(const int channel_index);
+	uint8_t *channel_get_high_valid(const int channel_index);
+
 	PoolByteArray channel_get_array(const int channel_index) const;
 	void channel_set_array(const int channel_index, const PoolByteArray &array);
 
 	PoolByteArray channel_get_compressed(const int channel_index) const;
 	void channel_set_compressed(const int channel_index, const PoolByteArray &data);
 
-	int get_index(const int x, const int y, const int z) const;
-	int get_data_index(const int x, const int y, const int z) const;
-	int get_data_size() const;
+	//data_serialize() format: u8 version, u8 layout, u16 channel count, u16 data size x, y, z,
+	//then per channel a u8 type, a u8 width (8 or 16), and the value / the data
+	enum {
+		DATA_VERSION = 1,
+		DATA_HEADER_SIZE = 10,
+		DATA_CHANNEL_NONE = 0,
+		DATA_CHANNEL_UNIFORM = 1,
+		DATA_CHANNEL_RAW = 2,
+
+		//u8 version, u32 uncompressed size, u64 dictionary hash (0 if none), then the lz4 block
+		DATA_COMPRESSED_VERSION = 2,
+		DATA_COMPRESSED_HEADER_SIZE = 13,
+	};
+
+	//Every channel (with the sizes, and the layout) in one buffer, uniform channels only take 2 bytes.
+	//Derived channels can be left out, they are deallocated when the data is read back.
+	PoolByteArray data_serialize(const bool include_derived = true) const;
+	bool data_deserialize(const PoolByteArray &data);
+
+	//data_serialize()'s output as one lz4 block, using the world's compression_dictionary if it has one.
+	PoolByteArray data_get_compressed(const bool include_derived = true) const;
+	bool data_set_compressed(const PoolByteArray &data);
+
+	//Writes at offset (resizing dst), returns the end of the written data (dst can be larger).
+	int data_compress_to(PoolByteArray &dst, const int offset, const bool include_derived) const;
+	bool data_decompress_from(const uint8_t *src, const int size);
+
+	//Like data_deserialize(), but the channels reference the data directly (read only) until they are written,
+	//owner is kept alive to keep the data valid. Falls back to copying when the data layout is different.
+	bool data_map(const uint8_t *d, const int size, const Ref<Reference> &owner);
+	bool channel_is_read_only(const int channel_index) const;
+
+	bool get_channel_packing() const;
+	void set_channel_packing(const bool value);
+
+	Ref<VoxelBufferPool> get_buffer_pool() const;
+	void set_buffer_pool(const Ref<VoxelBufferPool> &pool);
+
+	//Fail on mapped channels, and channels shared with a build's snapshot, they'd have to be copied first
+	bool channel_pack(const int channel_index);
+	void channel_unpack(const int channel_index);
+	void channels_pack();
+	bool channel_is_packed(const int channel_index) const;
+	bool channel_is_uniform(const int channel_index) const;
+	bool channel_collapse(const int channel_index);
+	int channel_get_bits_per_voxel(const int channel_index) const;
+	//Bytes allocated for the channels, build snapshots, and evicted data included. It's kept up to date on every allocation.
+	int64_t get_memory_usage() const;
+
+	//Eviction compresses every allocated channel with LZ4, and frees the buffers.
+	//Dropping frees them without a copy, the world generates them again. Only for chunks that weren't edited.
+	//Accessing the channels in any way restores them. Dropped channels can only be restored on the main thread, while the chunk is in a world.
+	bool channels_evict();
+	bool channels_drop();
+	void channels_restore();
+	bool channels_is_evicted() const;
+
+	//The world's running total, allocations, and frees are added to it while the chunk is in the world
+	void memory_usage_attach(SafeNumeric<uint64_t> *counter);
+
+	_FORCE_INLINE_ SelfList<VoxelChunk> *lru_get_item() {
+		return &_lru_item;
+	}
+
+	//Edit tracking. The world enables it after generation, from then on set_voxel(), and write_region_from() record
+	//which voxels changed, so only those need to be saved. Writes through raw channel pointers are not recorded.
+	//Chunks without tracking, or whose channels were replaced as a whole count as fully modified.
+	bool get_edit_tracking() const;
+	void set_edit_tracking(const bool value);
+
+	bool get_modified() const;
+	void set_modified(const bool value);
+	bool get_modified_full() const;
+	int modified_get_count() const;
+
+	//Indices of the modified voxels in data space (x + data_size_x * (y + data_size_y * z), margins included)
+	PoolIntArray modified_get_indices() const;
+
+	//Build snapshots. While one is active the build reads the channels as they were when it started,
+	//writers clone the channels they touch instead of modifying the shared buffers.
+	void snapshot_create();
+	void snapshot_release();
+	bool snapshot_is_active() const;
+
+	//Read only, falls back to channel_get() when there is no snapshot
+	uint8_t *channel_get_snapshot(const int channel_index);
+	uint8_t *channel_get_high_snapshot(const int channel_index);
+	uint8_t get_voxel_snapshot(const int p_x, const int p_y, const int p_z, const int p_channel_index) const;
+	//channel_is_uniform() of the snapshot, builds use this, the live channels might change under them
+	bool channel_is_uniform_snapshot(const int channel_index) const;
+
+	_FORCE_INLINE_ int get_index(const int x, const int y, const int z) const {
+		return get_data_index(x + _margin_start, y + _margin_start, z + _margin_start);
+	}
+
+	_FORCE_INLINE_ int get_data_index(const int x, const int y, const int z) const {
+		if (_data_layout == DATA_LAYOUT_LINEAR)
+			return y + _data_size_y * (x + _data_size_x * z);
+
+		return _data_index_x.ptr()[x] + _data_index_y.ptr()[y] + _data_index_z.ptr()[z];
+	}
+
+	_FORCE_INLINE_ int get_data_size() const {
+		return _data_capacity;
+	}
+
+	//Regions use the same coordinates as get_voxel. The buffer stores the channels after each other,
+	//one byte per voxel in y, x, z order. Bounds are only checked once per region.
+	bool validate_region(const int x, const int y, const int z, const int size_x, const int size_y, const int size_z) const;
+	bool copy_region_to(uint8_t *buffer, const AABB &region, const Vector<int> &channels, const bool from_snapshot = false) const;
+	bool write_region_from(const uint8_t *buffer, const AABB &region, const Vector<int> &channels);
+
+	//Same, with one uint16_t per voxel. These keep the high bytes of 16 bit channels, the 8 bit versions only
+	//read the low bytes, and clear the high bytes when writing (like set_voxel()).
+	bool copy_region16_to(uint16_t *buffer, const AABB &region, const Vector<int> &channels, const bool from_snapshot = false) const;
+	bool write_region16_from(const uint16_t *buffer, const AABB &region, const Vector<int> &channels);
+
+	PoolByteArray copy_region_to_bind(const AABB &region, const PoolIntArray &channels) const;
+	void write_region_from_bind(const PoolByteArray &buffer, const AABB &region, const PoolIntArray &channels);
+
+	//No checks at all, only use these after validate_region(), and with existing channels.
+	_FORCE_INLINE_ uint8_t get_voxel_unchecked(const int x, const int y, const int z, const int channel_index) const {
+		const VoxelChannel &ch = _channels.ptr()[channel_index];
+		int index = get_index(x, y, z);
+
+		if (ch.data)
+			return ch.data[index];
+
+		if (ch.packed)
+			return _channel_packed_get(ch, index);
+
+		return ch.palette[0];
+	}
+
+	_FORCE_INLINE_ uint8_t get_voxel_snapshot_unchecked(const int x, const int y, const int z, const int channel_index) const {
+		if (!_snapshot_active)
+			return get_voxel_unchecked(x, y, z, channel_index);
+
+		const VoxelChannel &ch = _snapshot_channels.ptr()[channel_index];
+		int index = get_index(x, y, z);
+
+		if (ch.data)
+			return ch.data[index];
+
+		if (ch.packed)
+			return _channel_packed_get(ch, index);
+
+		return ch.palette[0];
+	}
+
+	//For raw channel pointers. WIDE is picked once per chunk (high is only non NULL when it's needed),
+	//so loops over 8 bit channels don't branch for every voxel
+	template <bool WIDE>
+	_FORCE_INLINE_ static uint16_t decode_voxel16(const uint8_t *low, const uint8_t *high, const int index) {
+		if (WIDE)
+			return low[index] | (high[index] << 8);
+
+		return low[index];
+	}
+
+	_FORCE_INLINE_ uint16_t get_voxel16_unchecked(const int x, const int y, const int z, const int channel_index) const {
+		const uint8_t *high = _channels.ptr()[channel_index].data_high;
+
+		if (!high)
+			return get_voxel_unchecked(x, y, z, channel_index);
+
+		return get_voxel_unchecked(x, y, z, channel_index) | (high[get_index(x, y, z)] << 8);
+	}
+
+	//Writes the voxel, and it's 6 direct neighbours into neighbourhood in this order: center, -x, +x, -y, +y, -z, +z
+	_FORCE_INLINE_ void get_voxel_neighbourhood_unchecked(const int x, const int y, const int z, const int channel_index, uint8_t *neighbourhood) const {
+		neighbourhood[0] = get_voxel_unchecked(x, y, z, channel_index);
+		neighbourhood[1] = get_voxel_unchecked(x - 1, y, z, channel_index);
+		neighbourhood[2] = get_voxel_unchecked(x + 1, y, z, channel_index);
+		neighbourhood[3] = get_voxel_unchecked(x, y - 1, z, channel_index);
+		neighbourhood[4] = get_voxel_unchecked(x, y + 1, z, channel_index);
+		neighbourhood[5] = get_voxel_unchecked(x, y, z - 1, channel_index);
+		neighbourhood[6] = get_voxel_unchecked(x, y, z + 1, channel_index);
+	}
 
 	//Voxel Structures
 	Ref<VoxelStructure> voxel_structure_get(const int index) const;
@@ -327,6 +556,99 @@ protected:
 		RID shape_rid;
 	};
 
+	enum {
+		CHANNEL_PALETTE_MAX_SIZE = 16,
+	};
+
+	int _data_serialized_size(const bool include_derived) const;
+	void _data_serialize_to(uint8_t *d, const bool include_derived) const;
+	bool _data_deserialize_from(const uint8_t *d, const int data_size);
+
+	//A channel is either stored densely (one byte per voxel in data),
+	//or as indices into a small palette (bits_per_voxel each in packed).
+	//If neither is allocated the whole channel is palette[0] (bits_per_voxel is 0 when it was explicitly filled).
+	struct VoxelChannel {
+		uint8_t *data;
+		uint8_t *packed;
+		//High bytes of 16 bit channels, always dense. NULL means they are all 0.
+		uint8_t *data_high;
+		bool wide;
+		uint8_t bits_per_voxel;
+		uint8_t palette_size;
+		uint8_t palette[CHANNEL_PALETTE_MAX_SIZE];
+
+		//Set by snapshot_create(), the buffers might be shared with the snapshot
+		bool shared;
+
+		//data, and data_high point into the memory given to data_map(), shared is set too, so writes copy them first
+		bool read_only;
+
+		bool derived;
+
+		VoxelChannel() {
+			data = NULL;
+			packed = NULL;
+			data_high = NULL;
+			wide = false;
+			bits_per_voxel = 8;
+			palette_size = 0;
+			palette[0] = 0;
+			shared = false;
+			read_only = false;
+			derived = false;
+		}
+	};
+
+	_FORCE_INLINE_ static uint8_t _channel_packed_get(const VoxelChannel &ch, const uint32_t index) {
+		uint32_t bit = index * ch.bits_per_voxel;
+
+		return ch.palette[(ch.packed[bit >> 3] >> (bit & 7)) & ((1 << ch.bits_per_voxel) - 1)];
+	}
+
+	_FORCE_INLINE_ static void _channel_packed_set_index(VoxelChannel &ch, const uint32_t index, const uint8_t palette_index) {
+		uint32_t bit = index * ch.bits_per_voxel;
+		uint8_t mask = ((1 << ch.bits_per_voxel) - 1) << (bit & 7);
+
+		ch.packed[bit >> 3] = (ch.packed[bit >> 3] & ~mask) | ((palette_index << (bit & 7)) & mask);
+	}
+
+	//Normal phase jobs go to the thread pool, or the built in scheduler when it's not present.
+	//Without worker threads they are executed by the world in time slices.
+	void _job_submit(const Ref<VoxelJob> &job);
+
+	void _data_layout_build_tables(const int layout, Vector<uint32_t> &index_x, Vector<uint32_t> &index_y, Vector<uint32_t> &index_z, uint32_t &capacity) const;
+	void _channel_fill_padding(uint8_t *data) const;
+
+	uint32_t _channel_get_packed_size(const int bits_per_voxel) const;
+	int _channel_palette_get_or_add(VoxelChannel &ch, const uint8_t value);
+	void _channel_repack(VoxelChannel &ch, const int bits_per_voxel);
+	void _channel_decode(const VoxelChannel &ch, uint8_t *dst) const;
+	void _channel_free(const int channel_index);
+	void _channel_detach(const int channel_index, const bool keep_data);
+	void _channel_high_collapse(const int channel_index);
+	uint8_t *_channel_buffer_alloc(const uint32_t size) const;
+	void _channel_buffer_free(uint8_t *buffer, const uint32_t size) const;
+	void _channel_set_uniform(VoxelChannel &ch, const uint8_t value);
+	void _memory_usage_add(const uint64_t size) const;
+	void _memory_usage_sub(const uint64_t size) const;
+
+	template <class T>
+	bool _region_copy(T *buffer, const AABB &region, const Vector<int> &channels, const bool from_snapshot) const;
+	template <class T>
+	bool _region_write(const T *buffer, const AABB &region, const Vector<int> &channels);
+
+	void _modified_mark(const int x, const int y, const int z);
+
+	_FORCE_INLINE_ void _modified_mark_full(const int channel_index) {
+		if (_edit_tracking && !_channels[channel_index].derived)
+			_modified_full = true;
+	}
+
+	_FORCE_INLINE_ void _channels_ensure_resident() const {
+		if (unlikely(_evicted))
+			const_cast<VoxelChunk *>(this)->channels_restore();
+	}
+
 protected:
 	virtual void _world_transform_changed();
 
@@ -351,6 +673,9 @@ protected:
 	bool _is_in_tree;
 
 	VoxelWorld *_voxel_world;
+	int _world_index;
+	int _active_lists;
+	int _active_list_indices[ACTIVE_LIST_INDEX_COUNT];
 
 	int _position_x;
 	int _position_y;
@@ -367,7 +692,36 @@ protected:
 	int _margin_start;
 	int _margin_end;
 
-	Vector<uint8_t *> _channels;
+	//Non linear layouts are computed as index_x[x] + index_y[y] + index_z[z]
+	int _data_layout;
+	uint32_t _data_capacity;
+	Vector<uint32_t> _data_index_x;
+	Vector<uint32_t> _data_index_y;
+	Vector<uint32_t> _data_index_z;
+
+	Vector<VoxelChannel> _channels;
+	bool _channel_packing;
+	Ref<VoxelBufferPool> _buffer_pool;
+
+	bool _snapshot_active;
+
+	Ref<Reference> _data_mapping_owner;
+	uint32_t _snapshot_data_size;
+	Vector<VoxelChannel> _snapshot_channels;
+	Vector<uint8_t *> _snapshot_decoded;
+
+	bool _evicted;
+	bool _evicted_regenerate;
+	Vector<PoolByteArray> _evicted_channels;
+
+	mutable SafeNumeric<uint64_t> _memory_usage;
+	SafeNumeric<uint64_t> *_memory_usage_counter;
+	SelfList<VoxelChunk> _lru_item;
+
+	bool _edit_tracking;
+	bool _modified_full;
+	int _modified_count;
+	Vector<uint32_t> _modified_bits;
 
 	float _voxel_scale;
 
@@ -392,6 +746,9 @@ protected:
 
 	bool _abort_build;
 	bool _queued_generation;
+	bool _build_channels_pending;
 };
 
+VARIANT_ENUM_CAST(VoxelChunk::DataLayout);
+
 #endif
@@ -0,0 +1,166 @@
+/*
+Copyright (c) 2019-2020 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "voxel_chunk_map.h"
+
+#include "voxel_chunk.h"
+
+#define VOXEL_CHUNK_MAP_MIN_CAPACITY 64
+
+Ref<VoxelChunk> VoxelChunkMap::get_threaded(const int x, const int y, const int z) const {
+	RWLockRead lock(_lock);
+
+	return Ref<VoxelChunk>(getptr(x, y, z));
+}
+
+bool VoxelChunkMap::set(const int x, const int y, const int z, VoxelChunk *chunk) {
+	ERR_FAIL_COND_V(!chunk, false);
+
+	RWLockWrite lock(_lock);
+
+	if (!_entries)
+		_resize(VOXEL_CHUNK_MAP_MIN_CAPACITY);
+	//Keep at most half of the slots used, so probe sequences stay short
+	else if (static_cast<uint32_t>(_size + 1) * 2 > _mask + 1)
+		_resize((_mask + 1) * 2);
+
+	uint32_t i = hash(x, y, z) & _mask;
+
+	while (_entries[i].chunk) {
+		Entry &e = _entries[i];
+
+		if (e.x == x && e.y == y && e.z == z)
+			return false;
+
+		i = (i + 1) & _mask;
+	}
+
+	Entry &e = _entries[i];
+
+	e.x = x;
+	e.y = y;
+	e.z = z;
+	e.chunk = chunk;
+
+	++_size;
+
+	return true;
+}
+
+bool VoxelChunkMap::erase(const int x, const int y, const int z) {
+	RWLockWrite lock(_lock);
+
+	if (_size == 0)
+		return false;
+
+	uint32_t i = hash(x, y, z) & _mask;
+
+	while (true) {
+		const Entry &e = _entries[i];
+
+		if (!e.chunk)
+			return false;
+
+		if (e.x == x && e.y == y && e.z == z)
+			break;
+
+		i = (i + 1) & _mask;
+	}
+
+	//Backward shift deletion, move every following entry that would be reachable from the hole into it
+	uint32_t j = i;
+
+	while (true) {
+		j = (j + 1) & _mask;
+
+		Entry &e = _entries[j];
+
+		if (!e.chunk)
+			break;
+
+		uint32_t home = hash(e.x, e.y, e.z) & _mask;
+
+		//Skip entries whose home slot is cyclically in (i, j]
+		if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+			continue;
+
+		_entries[i] = e;
+		i = j;
+	}
+
+	_entries[i].chunk = NULL;
+
+	--_size;
+
+	return true;
+}
+
+void VoxelChunkMap::clear() {
+	RWLockWrite lock(_lock);
+
+	if (_entries) {
+		memdelete_arr(_entries);
+		_entries = NULL;
+	}
+
+	_mask = 0;
+	_size = 0;
+}
+
+int VoxelChunkMap::get_capacity() const {
+	return _entries ? _mask + 1 : 0;
+}
+
+VoxelChunkMap::VoxelChunkMap() {
+	_entries = NULL;
+	_mask = 0;
+	_size = 0;
+}
+
+VoxelChunkMap::~VoxelChunkMap() {
+	clear();
+}
+
+void VoxelChunkMap::_resize(const uint32_t capacity) {
+	Entry *old_entries = _entries;
+	uint32_t old_capacity = _entries ? _mask + 1 : 0;
+
+	_entries = memnew_arr(Entry, capacity);
+	_mask = capacity - 1;
+
+	for (uint32_t j = 0; j < old_capacity; ++j) {
+		const Entry &e = old_entries[j];
+
+		if (!e.chunk)
+			continue;
+
+		uint32_t i = hash(e.x, e.y, e.z) & _mask;
+
+		while (_entries[i].chunk)
+			i = (i + 1) & _mask;
+
+		_entries[i] = e;
+	}
+
+	if (old_entries)
+		memdelete_arr(old_entries);
+}
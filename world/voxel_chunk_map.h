@@ -0,0 +1,124 @@
+/*
+Copyright (c) 2019-2020 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef VOXEL_CHUNK_MAP_H
+#define VOXEL_CHUNK_MAP_H
+
+#include "core/version.h"
+
+#if VERSION_MAJOR > 3
+#include "core/object/reference.h"
+#else
+#include "core/reference.h"
+#endif
+
+#include "core/os/rw_lock.h"
+
+class VoxelChunk;
+
+//Flat, open addressing (linear probing) map from chunk positions to chunks.
+//Lookups are a single probe sequence over one continuous array, removals shift entries back, so there are no tombstones.
+//It doesn't own the chunks, the world keeps references to them in it's chunk list.
+//Only the owner world's (main) thread is allowed to modify it. It can read without locking, since it can't race
+//with itself. Other threads have to use get_threaded(), which takes a read lock, so they only wait for writes,
+//not for each other.
+class VoxelChunkMap {
+public:
+	static _FORCE_INLINE_ uint32_t hash(const int x, const int y, const int z) {
+		//Mix every coordinate with a different odd constant, then finish with murmur3's avalanche step
+		uint32_t h = static_cast<uint32_t>(x) * 0x8DA6B343;
+		h ^= static_cast<uint32_t>(y) * 0xD8163841;
+		h ^= static_cast<uint32_t>(z) * 0xCB1AB31F;
+
+		h ^= h >> 16;
+		h *= 0x85EBCA6B;
+		h ^= h >> 13;
+		h *= 0xC2B2AE35;
+		h ^= h >> 16;
+
+		return h;
+	}
+
+	_FORCE_INLINE_ VoxelChunk *getptr(const int x, const int y, const int z) const {
+		if (_size == 0)
+			return NULL;
+
+		uint32_t i = hash(x, y, z) & _mask;
+
+		while (true) {
+			const Entry &e = _entries[i];
+
+			if (!e.chunk)
+				return NULL;
+
+			if (e.x == x && e.y == y && e.z == z)
+				return e.chunk;
+
+			i = (i + 1) & _mask;
+		}
+	}
+
+	_FORCE_INLINE_ bool has(const int x, const int y, const int z) const {
+		return getptr(x, y, z) != NULL;
+	}
+
+	Ref<VoxelChunk> get_threaded(const int x, const int y, const int z) const;
+
+	//Returns false, if the position was already used
+	bool set(const int x, const int y, const int z, VoxelChunk *chunk);
+	bool erase(const int x, const int y, const int z);
+	void clear();
+
+	_FORCE_INLINE_ int size() const {
+		return _size;
+	}
+
+	int get_capacity() const;
+
+	VoxelChunkMap();
+	~VoxelChunkMap();
+
+protected:
+	struct Entry {
+		int x;
+		int y;
+		int z;
+		VoxelChunk *chunk;
+
+		Entry() {
+			x = 0;
+			y = 0;
+			z = 0;
+			chunk = NULL;
+		}
+	};
+
+	void _resize(const uint32_t capacity);
+
+	Entry *_entries;
+	uint32_t _mask;
+	int _size;
+
+	mutable RWLock _lock;
+};
+
+#endif
@@ -0,0 +1,617 @@
+/*
+Copyright (c) 2019-2020 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "voxel_region_store.h"
+
+#include "core/io/marshalls.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+
+#include "voxel_chunk.h"
+
+//Rounds towards negative infinity, unlike /
+_FORCE_INLINE_ static int floor_div(const int a, const int b) {
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+enum {
+	CHUNK_DATA_FULL = 1,
+	CHUNK_DATA_DELTA = 2,
+	CHUNK_DATA_HEADER_SIZE = 10,
+
+	//u8 type, then VoxelChunk::data_get_compressed()'s output
+	CHUNK_DATA_FULL_HEADER_SIZE = 1 + VoxelChunk::DATA_COMPRESSED_HEADER_SIZE,
+};
+
+String VoxelRegionStore::get_directory() const {
+	return _directory;
+}
+void VoxelRegionStore::set_directory(const String &value) {
+	flush();
+
+	_directory = value;
+	_directory_created = false;
+}
+
+int VoxelRegionStore::get_pending_count() {
+	_mutex.lock();
+	int pending = _pending;
+	_mutex.unlock();
+
+	return pending;
+}
+
+void VoxelRegionStore::save_chunk(const Ref<VoxelChunk> &chunk) {
+	ERR_FAIL_COND(!chunk.is_valid());
+
+	Request r;
+	r.x = chunk->get_position_x();
+	r.y = chunk->get_position_y();
+	r.z = chunk->get_position_z();
+	r.write = true;
+	r.data = chunk_serialize(chunk);
+
+	_request_push(r);
+}
+
+void VoxelRegionStore::load_request(const int x, const int y, const int z) {
+	Request r;
+	r.x = x;
+	r.y = y;
+	r.z = z;
+
+	_request_push(r);
+}
+bool VoxelRegionStore::load_poll(int &r_x, int &r_y, int &r_z, PoolByteArray &r_data) {
+	_mutex.lock();
+
+	if (_results.size() == 0) {
+		_mutex.unlock();
+		return false;
+	}
+
+	const Request &r = _results.front()->get();
+
+	r_x = r.x;
+	r_y = r.y;
+	r_z = r.z;
+	r_data = r.data;
+
+	_results.pop_front();
+
+	_mutex.unlock();
+
+	return true;
+}
+
+bool VoxelRegionStore::load_chunk(Ref<VoxelChunk> chunk) {
+	ERR_FAIL_COND_V(!chunk.is_valid(), false);
+
+	flush();
+
+	PoolByteArray data;
+
+	if (!_read(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z(), data))
+		return false;
+
+	return chunk_deserialize(chunk, data);
+}
+
+void VoxelRegionStore::flush() {
+	_mutex.lock();
+
+	if (_pending == 0) {
+		_mutex.unlock();
+		return;
+	}
+
+	++_flush_waiters;
+
+	_mutex.unlock();
+
+	_flush_semaphore.wait();
+}
+bool VoxelRegionStore::is_open() const {
+	return _directory != "";
+}
+
+PoolByteArray VoxelRegionStore::chunk_serialize(const Ref<VoxelChunk> &chunk) {
+	ERR_FAIL_COND_V(!chunk.is_valid(), PoolByteArray());
+
+	int data_size = chunk->get_data_size_x() * chunk->get_data_size_y() * chunk->get_data_size_z();
+
+	//Only the changes are stored when the baseline is the generator's output, and not too much was changed
+	if (chunk->get_edit_tracking() && !chunk->get_modified_full() && chunk->modified_get_count() <= data_size / 8)
+		return _chunk_serialize_delta(chunk);
+
+	return _chunk_serialize_full(chunk);
+}
+
+bool VoxelRegionStore::chunk_deserialize(Ref<VoxelChunk> chunk, const PoolByteArray &data) {
+	ERR_FAIL_COND_V(!chunk.is_valid(), false);
+	ERR_FAIL_COND_V(data.size() < CHUNK_DATA_FULL_HEADER_SIZE, false);
+
+	if (data_is_delta(data)) {
+		ERR_FAIL_COND_V(data.size() < CHUNK_DATA_HEADER_SIZE, false);
+
+		return _chunk_apply_delta(chunk, data);
+	}
+
+	return _chunk_deserialize_full(chunk, data);
+}
+
+bool VoxelRegionStore::data_is_delta(const PoolByteArray &data) const {
+	return data.size() > 0 && data[0] == CHUNK_DATA_DELTA;
+}
+
+PoolByteArray VoxelRegionStore::_chunk_serialize_full(const Ref<VoxelChunk> &chunk) {
+	PoolByteArray arr;
+
+	//Derived channels are recalculated by the build anyway
+	int size = chunk->data_compress_to(arr, 1, false);
+	arr.resize(size);
+
+#if !GODOT4
+	PoolByteArray::Write w = arr.write();
+	w[0] = CHUNK_DATA_FULL;
+#else
+	arr.set(0, CHUNK_DATA_FULL);
+#endif
+
+	return arr;
+}
+
+PoolByteArray VoxelRegionStore::_chunk_serialize_delta(const Ref<VoxelChunk> &chunk) {
+	PoolByteArray arr;
+
+	int channel_count = chunk->channel_get_count();
+	PoolIntArray indices = chunk->modified_get_indices();
+
+	Vector<uint8_t> widths;
+	widths.resize(channel_count);
+
+	int voxel_size = 4;
+
+	for (int i = 0; i < channel_count; ++i) {
+		if (chunk->channel_get_derived(i) || !chunk->channel_is_allocated(i)) {
+			widths.write[i] = 0;
+		} else {
+			widths.write[i] = chunk->channel_get_width(i);
+			voxel_size += widths[i] / 8;
+		}
+	}
+
+	arr.resize(CHUNK_DATA_HEADER_SIZE + channel_count + 4 + indices.size() * voxel_size);
+
+#if !GODOT4
+	PoolByteArray::Write w = arr.write();
+	uint8_t *d = w.ptr();
+
+	PoolIntArray::Read ir = indices.read();
+	const int *idx = ir.ptr();
+#else
+	uint8_t *d = arr.ptrw();
+	const int *idx = indices.ptr();
+#endif
+
+	int dsx = chunk->get_data_size_x();
+	int dsy = chunk->get_data_size_y();
+	int ms = chunk->get_margin_start();
+
+	d[0] = CHUNK_DATA_DELTA;
+	d[1] = 0;
+	encode_uint16(channel_count, d + 2);
+	encode_uint16(dsx, d + 4);
+	encode_uint16(dsy, d + 6);
+	encode_uint16(chunk->get_data_size_z(), d + 8);
+
+	int offset = CHUNK_DATA_HEADER_SIZE;
+
+	for (int i = 0; i < channel_count; ++i)
+		d[offset++] = widths[i];
+
+	encode_uint32(indices.size(), d + offset);
+	offset += 4;
+
+	for (int j = 0; j < indices.size(); ++j) {
+		int index = idx[j];
+
+		int x = index % dsx - ms;
+		int y = (index / dsx) % dsy - ms;
+		int z = index / (dsx * dsy) - ms;
+
+		encode_uint32(index, d + offset);
+		offset += 4;
+
+		for (int i = 0; i < channel_count; ++i) {
+			if (widths[i] == 8) {
+				d[offset++] = chunk->get_voxel(x, y, z, i);
+			} else if (widths[i] == 16) {
+				encode_uint16(chunk->get_voxel16(x, y, z, i), d + offset);
+				offset += 2;
+			}
+		}
+	}
+
+	return arr;
+}
+
+bool VoxelRegionStore::_chunk_apply_delta(Ref<VoxelChunk> chunk, const PoolByteArray &data) {
+#if !GODOT4
+	PoolByteArray::Read r = data.read();
+	const uint8_t *d = r.ptr();
+#else
+	const uint8_t *d = data.ptr();
+#endif
+
+	int channel_count = decode_uint16(d + 2);
+	int dsx = decode_uint16(d + 4);
+	int dsy = decode_uint16(d + 6);
+	int dsz = decode_uint16(d + 8);
+
+	if (dsx != chunk->get_data_size_x() || dsy != chunk->get_data_size_y() || dsz != chunk->get_data_size_z()) {
+		ERR_FAIL_V_MSG(false, "Error, the stored chunk has a different size!");
+	}
+
+	int size = data.size();
+	int offset = CHUNK_DATA_HEADER_SIZE;
+
+	ERR_FAIL_COND_V_MSG(offset + channel_count + 4 > size, false, "Error, the stored chunk data is corrupt!");
+
+	const uint8_t *widths = d + offset;
+	offset += channel_count;
+
+	int voxel_size = 4;
+
+	for (int i = 0; i < channel_count; ++i) {
+		ERR_FAIL_COND_V_MSG(widths[i] != 0 && widths[i] != 8 && widths[i] != 16, false, "Error, the stored chunk data is corrupt!");
+
+		voxel_size += widths[i] / 8;
+	}
+
+	int count = decode_uint32(d + offset);
+	offset += 4;
+
+	ERR_FAIL_COND_V_MSG(count < 0 || offset + count * voxel_size > size, false, "Error, the stored chunk data is corrupt!");
+
+	if (chunk->channel_get_count() < channel_count)
+		chunk->channel_set_count(channel_count);
+
+	for (int i = 0; i < channel_count; ++i) {
+		if (widths[i] > chunk->channel_get_width(i))
+			chunk->channel_set_width(i, widths[i]);
+	}
+
+	int ms = chunk->get_margin_start();
+
+	for (int j = 0; j < count; ++j) {
+		int index = decode_uint32(d + offset);
+		offset += 4;
+
+		ERR_FAIL_INDEX_V(index, dsx * dsy * dsz, false);
+
+		int x = index % dsx - ms;
+		int y = (index / dsx) % dsy - ms;
+		int z = index / (dsx * dsy) - ms;
+
+		for (int i = 0; i < channel_count; ++i) {
+			if (widths[i] == 8) {
+				chunk->set_voxel(d[offset++], x, y, z, i);
+			} else if (widths[i] == 16) {
+				chunk->set_voxel16(decode_uint16(d + offset), x, y, z, i);
+				offset += 2;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool VoxelRegionStore::_chunk_deserialize_full(Ref<VoxelChunk> chunk, const PoolByteArray &data) {
+#if !GODOT4
+	PoolByteArray::Read r = data.read();
+	const uint8_t *d = r.ptr();
+#else
+	const uint8_t *d = data.ptr();
+#endif
+
+	ERR_FAIL_COND_V_MSG(d[0] != CHUNK_DATA_FULL, false, "Error, unknown chunk data version!");
+
+	return chunk->data_decompress_from(d + 1, data.size() - 1);
+}
+
+VoxelRegionStore::VoxelRegionStore() {
+	_directory_created = false;
+	_thread_exit = false;
+	_pending = 0;
+	_flush_waiters = 0;
+}
+
+VoxelRegionStore::~VoxelRegionStore() {
+	_thread_stop();
+
+	_requests.clear();
+	_results.clear();
+}
+
+String VoxelRegionStore::_get_region_path(const int x, const int y, const int z) const {
+	return _directory.plus_file("r." + itos(floor_div(x, REGION_SIZE)) + "." + itos(floor_div(y, REGION_SIZE)) + "." + itos(floor_div(z, REGION_SIZE)) + ".vxr");
+}
+int VoxelRegionStore::_get_region_index(const int x, const int y, const int z) const {
+	int lx = x - floor_div(x, REGION_SIZE) * REGION_SIZE;
+	int ly = y - floor_div(y, REGION_SIZE) * REGION_SIZE;
+	int lz = z - floor_div(z, REGION_SIZE) * REGION_SIZE;
+
+	return lx + REGION_SIZE * (ly + REGION_SIZE * lz);
+}
+
+bool VoxelRegionStore::_read(const int x, const int y, const int z, PoolByteArray &r_data) {
+	String path = _get_region_path(x, y, z);
+
+	if (!FileAccess::exists(path))
+		return false;
+
+	FileAccess *f = FileAccess::open(path, FileAccess::READ);
+
+	ERR_FAIL_COND_V_MSG(!f, false, "Error, can't open region file: " + path);
+
+	if (f->get_len() < REGION_FILE_HEADER_SIZE || f->get_32() != REGION_FILE_MAGIC || f->get_32() != REGION_FILE_VERSION) {
+		memdelete(f);
+		ERR_FAIL_V_MSG(false, "Error, invalid region file: " + path);
+	}
+
+	f->seek(8 + _get_region_index(x, y, z) * 8);
+
+	uint32_t offset = f->get_32();
+	uint32_t size = f->get_32();
+
+	if (offset == 0 || offset + size > f->get_len()) {
+		memdelete(f);
+		return false;
+	}
+
+	r_data.resize(size);
+
+	f->seek(offset);
+
+#if !GODOT4
+	PoolByteArray::Write w = r_data.write();
+	f->get_buffer(w.ptr(), size);
+	w.release();
+#else
+	f->get_buffer(r_data.ptrw(), size);
+#endif
+
+	memdelete(f);
+
+	return true;
+}
+bool VoxelRegionStore::_write(const int x, const int y, const int z, const PoolByteArray &data) {
+	if (!_directory_created) {
+		DirAccess *da = DirAccess::create_for_path(_directory);
+
+		if (da) {
+			da->make_dir_recursive(_directory);
+			memdelete(da);
+		}
+
+		_directory_created = true;
+	}
+
+	String path = _get_region_path(x, y, z);
+	FileAccess *f = NULL;
+
+	if (FileAccess::exists(path)) {
+		f = FileAccess::open(path, FileAccess::READ_WRITE);
+
+		ERR_FAIL_COND_V_MSG(!f, false, "Error, can't open region file: " + path);
+
+		if (f->get_len() < REGION_FILE_HEADER_SIZE || f->get_32() != REGION_FILE_MAGIC || f->get_32() != REGION_FILE_VERSION) {
+			memdelete(f);
+			ERR_FAIL_V_MSG(false, "Error, invalid region file: " + path);
+		}
+	} else {
+		f = FileAccess::open(path, FileAccess::WRITE_READ);
+
+		ERR_FAIL_COND_V_MSG(!f, false, "Error, can't create region file: " + path);
+
+		f->store_32(REGION_FILE_MAGIC);
+		f->store_32(REGION_FILE_VERSION);
+
+		for (int i = 0; i < REGION_CHUNK_COUNT * 2; ++i)
+			f->store_32(0);
+	}
+
+	int entry_index = _get_region_index(x, y, z);
+	int entry = 8 + entry_index * 8;
+
+	f->seek(entry);
+
+	uint32_t offset = f->get_32();
+	uint32_t old_size = f->get_32();
+	uint32_t size = data.size();
+
+	//Overwrite in place if it fits, the rest of the old space becomes free
+	if (offset == 0 || size > old_size)
+		offset = _find_free_space(f, entry_index, size);
+
+	f->seek(offset);
+
+#if !GODOT4
+	PoolByteArray::Read r = data.read();
+	f->store_buffer(r.ptr(), size);
+#else
+	f->store_buffer(data.ptr(), size);
+#endif
+
+	f->seek(entry);
+	f->store_32(offset);
+	f->store_32(size);
+
+	memdelete(f);
+
+	return true;
+}
+
+uint32_t VoxelRegionStore::_find_free_space(FileAccess *f, const int entry_index, const uint32_t size) {
+	struct Slot {
+		uint32_t offset;
+		uint32_t size;
+
+		bool operator<(const Slot &other) const {
+			return offset < other.offset;
+		}
+	};
+
+	Vector<uint8_t> table;
+	table.resize(REGION_CHUNK_COUNT * 8);
+
+	f->seek(8);
+	f->get_buffer(table.ptrw(), table.size());
+
+	const uint8_t *t = table.ptr();
+
+	Vector<Slot> slots;
+
+	for (int i = 0; i < REGION_CHUNK_COUNT; ++i) {
+		Slot slot;
+		slot.offset = decode_uint32(t + i * 8);
+		slot.size = decode_uint32(t + i * 8 + 4);
+
+		//The chunk's own space is free, it gets replaced
+		if (i == entry_index || slot.offset == 0 || slot.size == 0)
+			continue;
+
+		slots.push_back(slot);
+	}
+
+	slots.sort();
+
+	//First fit, space that got freed by moved, or shrunk chunks is reused, and the file only grows if nothing fits.
+	//The end of the last chunk is returned otherwise, so the unused space at the end of the file gets reused too.
+	uint32_t pos = REGION_FILE_HEADER_SIZE;
+
+	for (int i = 0; i < slots.size(); ++i) {
+		const Slot &slot = slots[i];
+
+		if (slot.offset >= pos + size)
+			return pos;
+
+		pos = MAX(pos, slot.offset + slot.size);
+	}
+
+	return pos;
+}
+
+void VoxelRegionStore::_request_push(const Request &request) {
+	ERR_FAIL_COND_MSG(_directory == "", "Error, set the region store's directory first!");
+
+	if (!_thread.is_started()) {
+		_thread_exit = false;
+		_thread.start(_thread_func, this);
+	}
+
+	_mutex.lock();
+	_requests.push_back(request);
+	++_pending;
+	_mutex.unlock();
+
+	_semaphore.post();
+}
+void VoxelRegionStore::_thread_stop() {
+	if (!_thread.is_started())
+		return;
+
+	//Pending writes still get done
+	_mutex.lock();
+	_thread_exit = true;
+	_mutex.unlock();
+
+	_semaphore.post();
+	_thread.wait_to_finish();
+}
+void VoxelRegionStore::_thread_func(void *p_userdata) {
+	VoxelRegionStore *self = static_cast<VoxelRegionStore *>(p_userdata);
+
+	while (true) {
+		self->_semaphore.wait();
+
+		self->_mutex.lock();
+
+		if (self->_requests.size() == 0) {
+			bool exit = self->_thread_exit;
+			self->_mutex.unlock();
+
+			if (exit)
+				return;
+
+			continue;
+		}
+
+		Request r = self->_requests.front()->get();
+		self->_requests.pop_front();
+
+		self->_mutex.unlock();
+
+		if (r.write) {
+			self->_write(r.x, r.y, r.z, r.data);
+			r.data = PoolByteArray();
+		} else {
+			//Empty data means that the chunk wasn't stored
+			if (!self->_read(r.x, r.y, r.z, r.data))
+				r.data = PoolByteArray();
+		}
+
+		self->_mutex.lock();
+
+		if (!r.write)
+			self->_results.push_back(r);
+
+		--self->_pending;
+
+		if (self->_pending == 0) {
+			for (int i = 0; i < self->_flush_waiters; ++i)
+				self->_flush_semaphore.post();
+
+			self->_flush_waiters = 0;
+		}
+
+		self->_mutex.unlock();
+	}
+}
+
+void VoxelRegionStore::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_directory"), &VoxelRegionStore::get_directory);
+	ClassDB::bind_method(D_METHOD("set_directory", "value"), &VoxelRegionStore::set_directory);
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "directory", PROPERTY_HINT_DIR), "set_directory", "get_directory");
+
+	ClassDB::bind_method(D_METHOD("get_pending_count"), &VoxelRegionStore::get_pending_count);
+
+	ClassDB::bind_method(D_METHOD("save_chunk", "chunk"), &VoxelRegionStore::save_chunk);
+	ClassDB::bind_method(D_METHOD("load_chunk", "chunk"), &VoxelRegionStore::load_chunk);
+	ClassDB::bind_method(D_METHOD("flush"), &VoxelRegionStore::flush);
+	ClassDB::bind_method(D_METHOD("is_open"), &VoxelRegionStore::is_open);
+
+	ClassDB::bind_method(D_METHOD("chunk_serialize", "chunk"), &VoxelRegionStore::chunk_serialize);
+	ClassDB::bind_method(D_METHOD("chunk_deserialize", "chunk", "data"), &VoxelRegionStore::chunk_deserialize);
+	ClassDB::bind_method(D_METHOD("data_is_delta", "data"), &VoxelRegionStore::data_is_delta);
+}
@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2019-2020 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef VOXEL_REGION_STORE_H
+#define VOXEL_REGION_STORE_H
+
+#include "core/version.h"
+
+#if VERSION_MAJOR > 3
+#include "core/object/reference.h"
+#include "core/string/ustring.h"
+#include "core/templates/list.h"
+#else
+#include "core/list.h"
+#include "core/reference.h"
+#include "core/ustring.h"
+#endif
+
+#include "../defines.h"
+
+#include pool_vector_h
+
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+
+class VoxelChunk;
+class FileAccess;
+
+//Stores chunks in region files, every file holds REGION_SIZE^3 chunks, and starts with an offset table.
+//Reading, and writing files is done by a background thread, chunks are (de)serialized on the caller's thread.
+class VoxelRegionStore : public Reference {
+	GDCLASS(VoxelRegionStore, Reference);
+
+public:
+	enum {
+		REGION_SIZE = 16,
+		REGION_CHUNK_COUNT = REGION_SIZE * REGION_SIZE * REGION_SIZE,
+		REGION_FILE_MAGIC = 0x46525856, //VXRF
+		REGION_FILE_VERSION = 3,
+		REGION_FILE_HEADER_SIZE = 8 + REGION_CHUNK_COUNT * 8,
+	};
+
+	String get_directory() const;
+	void set_directory(const String &value);
+
+	int get_pending_count();
+
+	//Serializes the chunk now, and writes it in the background
+	void save_chunk(const Ref<VoxelChunk> &chunk);
+
+	//Reads in the background, results can be collected with load_poll()
+	void load_request(const int x, const int y, const int z);
+	bool load_poll(int &r_x, int &r_y, int &r_z, PoolByteArray &r_data);
+
+	//Blocking, waits for the pending requests first
+	bool load_chunk(Ref<VoxelChunk> chunk);
+	void flush();
+	bool is_open() const;
+
+	//Chunks with edit tracking only store their modified voxels (as long as there aren't too many of them).
+	//These deltas are applied on top of the chunk's current data, so it needs to be generated first.
+	PoolByteArray chunk_serialize(const Ref<VoxelChunk> &chunk);
+	bool chunk_deserialize(Ref<VoxelChunk> chunk, const PoolByteArray &data);
+	bool data_is_delta(const PoolByteArray &data) const;
+
+	VoxelRegionStore();
+	~VoxelRegionStore();
+
+protected:
+	static void _bind_methods();
+
+	struct Request {
+		int x;
+		int y;
+		int z;
+		bool write;
+		PoolByteArray data;
+
+		Request() {
+			x = 0;
+			y = 0;
+			z = 0;
+			write = false;
+		}
+	};
+
+	PoolByteArray _chunk_serialize_full(const Ref<VoxelChunk> &chunk);
+	PoolByteArray _chunk_serialize_delta(const Ref<VoxelChunk> &chunk);
+	bool _chunk_deserialize_full(Ref<VoxelChunk> chunk, const PoolByteArray &data);
+	bool _chunk_apply_delta(Ref<VoxelChunk> chunk, const PoolByteArray &data);
+
+	String _get_region_path(const int x, const int y, const int z) const;
+	int _get_region_index(const int x, const int y, const int z) const;
+
+	bool _read(const int x, const int y, const int z, PoolByteArray &r_data);
+	bool _write(const int x, const int y, const int z, const PoolByteArray &data);
+	uint32_t _find_free_space(FileAccess *f, const int entry_index, const uint32_t size);
+
+	void _request_push(const Request &request);
+	void _thread_stop();
+	static void _thread_func(void *p_userdata);
+
+	String _directory;
+	bool _directory_created;
+
+	Thread _thread;
+	Semaphore _semaphore;
+	Mutex _mutex;
+	bool _thread_exit;
+
+	//flush() waits on this, the thread posts it once for every waiter when _pending reaches 0
+	Semaphore _flush_semaphore;
+	int _flush_waiters;
+
+	List<Request> _requests;
+	List<Request> _results;
+	int _pending;
+};
+
+#endif
@@ -24,6 +24,15 @@ SOFTWARE.
 
 #include "core/version.h"
 
+#if VERSION_MAJOR > 3
+#include "core/crypto/crypto_core.h"
+#else
+#include "core/math/crypto_core.h"
+#endif
+
+#include "core/io/marshalls.h"
+
+#include "jobs/voxel_job.h"
 #include "voxel_chunk.h"
 #include "voxel_structure.h"
 
@@ -42,6 +51,100 @@ SOFTWARE.
 #endif
 
 const String VoxelWorld::BINDING_STRING_CHANNEL_TYPE_INFO = "Type,Isolevel,Liquid,Liquid Level";
+const String VoxelWorld::BINDING_STRING_STREAMING_SHAPE = "Sphere,Cylinder";
+
+//Rounds towards negative infinity, unlike /
+_FORCE_INLINE_ static int floor_div(const int a, const int b) {
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+//Binary min heaps, T needs operator<
+template <class T>
+static void heap_sift_up(T *heap, int index) {
+	while (index > 0) {
+		int parent = (index - 1) / 2;
+
+		if (!(heap[index] < heap[parent]))
+			return;
+
+		SWAP(heap[index], heap[parent]);
+		index = parent;
+	}
+}
+template <class T>
+static void heap_sift_down(T *heap, const int size, int index) {
+	while (true) {
+		int left = index * 2 + 1;
+		int right = left + 1;
+		int smallest = index;
+
+		if (left < size && heap[left] < heap[smallest])
+			smallest = left;
+
+		if (right < size && heap[right] < heap[smallest])
+			smallest = right;
+
+		if (smallest == index)
+			return;
+
+		SWAP(heap[index], heap[smallest]);
+		index = smallest;
+	}
+}
+
+_FORCE_INLINE_ static bool region_copy(const Ref<VoxelChunk> &chunk, uint8_t *buffer, const AABB &region, const Vector<int> &channels) {
+	return chunk->copy_region_to(buffer, region, channels);
+}
+_FORCE_INLINE_ static bool region_copy(const Ref<VoxelChunk> &chunk, uint16_t *buffer, const AABB &region, const Vector<int> &channels) {
+	return chunk->copy_region16_to(buffer, region, channels);
+}
+_FORCE_INLINE_ static bool region_write(const Ref<VoxelChunk> &chunk, const uint8_t *buffer, const AABB &region, const Vector<int> &channels) {
+	return chunk->write_region_from(buffer, region, channels);
+}
+_FORCE_INLINE_ static bool region_write(const Ref<VoxelChunk> &chunk, const uint16_t *buffer, const AABB &region, const Vector<int> &channels) {
+	return chunk->write_region16_from(buffer, region, channels);
+}
+
+//Sets every voxel of the region (or only the ones inside the sphere) in one chunk.
+//offset is the position of the region's first voxel center in world voxel space.
+template <class T>
+static bool region_fill(const Ref<VoxelChunk> &chunk, Vector<T> &buffer, const AABB &region, const Vector<int> &channels, const bool sphere, const Vector3 &offset, const Vector3 &center, const float radius_squared, const T value) {
+	int sx = static_cast<int>(region.size.x);
+	int sy = static_cast<int>(region.size.y);
+	int sz = static_cast<int>(region.size.z);
+
+	buffer.resize(sx * sy * sz);
+	T *b = buffer.ptrw();
+
+	if (!sphere) {
+		for (int i = 0; i < sx * sy * sz; ++i) {
+			b[i] = value;
+		}
+
+		return region_write(chunk, b, region, channels);
+	}
+
+	//The voxels outside the sphere are written back unchanged
+	if (!region_copy(chunk, b, region, channels))
+		return false;
+
+	for (int z = 0; z < sz; ++z) {
+		float dz = offset.z + z - center.z;
+
+		for (int x = 0; x < sx; ++x) {
+			float dx = offset.x + x - center.x;
+
+			for (int y = 0; y < sy; ++y) {
+				float dy = offset.y + y - center.y;
+
+				if (dx * dx + dy * dy + dz * dz <= radius_squared)
+					b[y + sy * (x + sx * z)] = value;
+			}
+		}
+	}
+
+	return region_write(chunk, b, region, channels);
+}
 
 bool VoxelWorld::get_editable() const {
 	return _editable;
@@ -85,6 +188,22 @@ void VoxelWorld::set_data_margin_end(const int value) {
 	_data_margin_end = value;
 }
 
+int VoxelWorld::get_data_layout() const {
+	return _data_layout;
+}
+void VoxelWorld::set_data_layout(const int value) {
+	_data_layout = value;
+
+	for (int i = 0; i < chunk_get_count(); ++i) {
+		Ref<VoxelChunk> c = chunk_get_index(i);
+
+		if (!c.is_valid())
+			continue;
+
+		c->set_data_layout(_data_layout);
+	}
+}
+
 int VoxelWorld::get_current_seed() const {
 	return _current_seed;
 }
@@ -122,6 +241,39 @@ void VoxelWorld::set_max_frame_chunk_build_steps(const int value) {
 	_max_frame_chunk_build_steps = value;
 }
 
+#if !THREAD_POOL_PRESENT
+float VoxelWorld::get_job_frame_budget() const {
+	return _job_frame_budget;
+}
+void VoxelWorld::set_job_frame_budget(const float value) {
+	_job_frame_budget = value;
+}
+
+void VoxelWorld::job_sliced_add(const Ref<VoxelJob> &job) {
+	ERR_FAIL_COND(!job.is_valid());
+
+	Ref<VoxelChunk> chunk = job->get_chunk();
+
+	SlicedJobEntry entry;
+	entry.job = job;
+	entry.priority = chunk.is_valid() ? _generation_get_priority(chunk) : 0;
+	entry.sequence = _sliced_jobs_sequence++;
+
+	_sliced_jobs.push_back(entry);
+	heap_sift_up(_sliced_jobs.ptrw(), _sliced_jobs.size() - 1);
+}
+int VoxelWorld::job_sliced_get_count() const {
+	return _sliced_jobs.size();
+}
+#endif
+
+float VoxelWorld::get_dirty_flush_interval() const {
+	return _dirty_flush_interval;
+}
+void VoxelWorld::set_dirty_flush_interval(const float value) {
+	_dirty_flush_interval = value;
+}
+
 Ref<VoxelmanLibrary> VoxelWorld::get_library() {
 	return _library;
 }
@@ -145,6 +297,22 @@ void VoxelWorld::set_level_generator(const Ref<VoxelmanLevelGenerator> &level_ge
 	_level_generator = level_generator;
 }
 
+Ref<VoxelBufferPool> VoxelWorld::get_buffer_pool() const {
+	return _buffer_pool;
+}
+void VoxelWorld::set_buffer_pool(const Ref<VoxelBufferPool> &pool) {
+	_buffer_pool = pool;
+
+	for (int i = 0; i < chunk_get_count(); ++i) {
+		Ref<VoxelChunk> c = chunk_get_index(i);
+
+		if (!c.is_valid())
+			continue;
+
+		c->set_buffer_pool(_buffer_pool);
+	}
+}
+
 float VoxelWorld::get_voxel_scale() const {
 	return _voxel_scale;
 }
@@ -166,6 +334,172 @@ int VoxelWorld::get_chunk_spawn_range() const {
 }
 void VoxelWorld::set_chunk_spawn_range(const int value) {
 	_chunk_spawn_range = value;
+
+	streaming_reset();
+}
+
+int VoxelWorld::get_chunk_spawn_range_y() const {
+	return _chunk_spawn_range_y;
+}
+void VoxelWorld::set_chunk_spawn_range_y(const int value) {
+	_chunk_spawn_range_y = value;
+
+	streaming_reset();
+}
+
+int VoxelWorld::get_chunk_despawn_margin() const {
+	return _chunk_despawn_margin;
+}
+void VoxelWorld::set_chunk_despawn_margin(const int value) {
+	_chunk_despawn_margin = value;
+
+	streaming_reset();
+}
+
+bool VoxelWorld::get_streaming() const {
+	return _streaming;
+}
+void VoxelWorld::set_streaming(const bool value) {
+	_streaming = value;
+
+	streaming_reset();
+}
+
+int VoxelWorld::get_streaming_shape() const {
+	return _streaming_shape;
+}
+void VoxelWorld::set_streaming_shape(const int value) {
+	_streaming_shape = value;
+
+	streaming_reset();
+}
+
+bool VoxelWorld::get_sparse_storage() const {
+	return _sparse_storage;
+}
+void VoxelWorld::set_sparse_storage(const bool value) {
+	_sparse_storage = value;
+}
+
+int64_t VoxelWorld::get_memory_budget() const {
+	return _memory_budget;
+}
+void VoxelWorld::set_memory_budget(const int64_t value) {
+	_memory_budget = value;
+	_memory_budget_stalled = false;
+}
+
+Ref<VoxelWorldPack> VoxelWorld::get_world_pack() const {
+	return _world_pack;
+}
+void VoxelWorld::set_world_pack(const Ref<VoxelWorldPack> &pack) {
+	_world_pack = pack;
+}
+
+PoolByteArray VoxelWorld::get_compression_dictionary() const {
+	PoolByteArray data;
+
+	compression_dictionary_find(get_compression_dictionary_hash(), data);
+
+	return data;
+}
+void VoxelWorld::set_compression_dictionary(const PoolByteArray &data) {
+	uint64_t hash = compression_dictionary_hash(data);
+
+	_compression_dictionary_mutex.lock();
+
+	//The old one stays, records that were compressed with it can still be read
+	if (hash != 0 && !_compression_dictionaries.has(hash))
+		_compression_dictionaries.set(hash, data);
+
+	_compression_dictionary_hash = hash;
+
+	_compression_dictionary_mutex.unlock();
+}
+uint64_t VoxelWorld::get_compression_dictionary_hash() const {
+	_compression_dictionary_mutex.lock();
+	uint64_t hash = _compression_dictionary_hash;
+	_compression_dictionary_mutex.unlock();
+
+	return hash;
+}
+
+Array VoxelWorld::get_compression_dictionary_history() const {
+	Array arr;
+
+	_compression_dictionary_mutex.lock();
+
+	const uint64_t *key = NULL;
+
+	while ((key = _compression_dictionaries.next(key))) {
+		if (*key != _compression_dictionary_hash)
+			arr.push_back(_compression_dictionaries.get(*key));
+	}
+
+	_compression_dictionary_mutex.unlock();
+
+	return arr;
+}
+void VoxelWorld::set_compression_dictionary_history(const Array &data) {
+	_compression_dictionary_mutex.lock();
+
+	for (int i = 0; i < data.size(); ++i) {
+		PoolByteArray d = data[i];
+		uint64_t hash = compression_dictionary_hash(d);
+
+		if (hash != 0 && !_compression_dictionaries.has(hash))
+			_compression_dictionaries.set(hash, d);
+	}
+
+	_compression_dictionary_mutex.unlock();
+}
+
+bool VoxelWorld::compression_dictionary_find(const uint64_t hash, PoolByteArray &r_data) const {
+	if (hash == 0)
+		return false;
+
+	_compression_dictionary_mutex.lock();
+
+	const PoolByteArray *data = _compression_dictionaries.getptr(hash);
+
+	//Copying only references the data, it stays valid even if the dictionary gets replaced
+	if (data)
+		r_data = *data;
+
+	_compression_dictionary_mutex.unlock();
+
+	return data != NULL;
+}
+uint64_t VoxelWorld::compression_dictionary_hash(const PoolByteArray &data) {
+	if (data.size() == 0)
+		return 0;
+
+	unsigned char sha[32];
+
+#if !GODOT4
+	PoolByteArray::Read r = data.read();
+	CryptoCore::sha256(r.ptr(), data.size(), sha);
+#else
+	CryptoCore::sha256(data.ptr(), data.size(), sha);
+#endif
+
+	uint64_t hash = decode_uint64(sha);
+
+	//0 means no dictionary
+	return hash != 0 ? hash : 1;
+}
+
+Ref<VoxelRegionStore> VoxelWorld::get_region_store() const {
+	return _region_store;
+}
+void VoxelWorld::set_region_store(const Ref<VoxelRegionStore> &store) {
+	if (_region_store == store)
+		return;
+
+	//The old store's results won't be polled anymore
+	_region_loading_cancel(true);
+
+	_region_store = store;
 }
 
 NodePath VoxelWorld::get_player_path() const {
@@ -263,19 +597,29 @@ void VoxelWorld::chunk_add(Ref<VoxelChunk> chunk, const int x, const int y, cons
 	ERR_FAIL_COND(!chunk.is_valid());
 	ERR_FAIL_COND_MSG(chunk->get_voxel_world() != NULL && chunk->get_voxel_world() != this, "Chunk is already owned by an another world!");
 
-	IntPos pos(x, y, z);
-
-	//ERR_FAIL_COND(_chunks.has(pos));
+	//ERR_FAIL_COND(_chunks.has(x, y, z));
 
 	chunk->set_voxel_world(this);
 	chunk->set_position(x, y, z);
 	chunk->world_transform_changed();
 
-	if (!_chunks.has(pos))
-		_chunks.set(pos, chunk);
+	if (!_chunks.has(x, y, z))
+		_chunks.set(x, y, z, chunk.ptr());
 
-	if (_chunks_vector.find(chunk) == -1)
+	if (!_chunks_vector_has(chunk)) {
+		chunk->set_world_index(_chunks_vector.size());
 		_chunks_vector.push_back(chunk);
+		_chunk_attach(chunk);
+	}
+
+	if (chunk->get_process())
+		active_process_add(chunk.ptr());
+
+	if (chunk->get_physics_process())
+		active_physics_process_add(chunk.ptr());
+
+	if (chunk->get_is_generating())
+		active_generating_add(chunk.ptr());
 
 	if (is_inside_tree())
 		chunk->enter_tree();
@@ -284,36 +628,57 @@ void VoxelWorld::chunk_add(Ref<VoxelChunk> chunk, const int x, const int y, cons
 		call("_chunk_added", chunk);
 }
 bool VoxelWorld::chunk_has(const int x, const int y, const int z) const {
-	return _chunks.has(IntPos(x, y, z));
+	return _chunks.has(x, y, z);
 }
 Ref<VoxelChunk> VoxelWorld::chunk_get(const int x, const int y, const int z) {
-	IntPos pos(x, y, z);
+	VoxelChunk *chunk = _chunks.getptr(x, y, z);
+
+	if (!chunk)
+		return Ref<VoxelChunk>();
 
-	if (_chunks.has(pos))
-		return _chunks.get(pos);
+	SelfList<VoxelChunk> *item = chunk->lru_get_item();
 
-	return Ref<VoxelChunk>();
+	if (item->in_list()) {
+		_chunks_lru.remove(item);
+		_chunks_lru.add_last(item);
+	}
+
+	return Ref<VoxelChunk>(chunk);
+}
+Ref<VoxelChunk> VoxelWorld::chunk_get_threaded(const int x, const int y, const int z) const {
+	return _chunks.get_threaded(x, y, z);
 }
 Ref<VoxelChunk> VoxelWorld::chunk_remove(const int x, const int y, const int z) {
-	IntPos pos(x, y, z);
+	VoxelChunk *c = _chunks.getptr(x, y, z);
 
-	if (!_chunks.has(pos))
+	if (!c)
 		return NULL;
 
-	Ref<VoxelChunk> chunk = _chunks.get(pos);
+	Ref<VoxelChunk> chunk = Ref<VoxelChunk>(c);
 
-	for (int i = 0; i < _chunks_vector.size(); ++i) {
-		if (_chunks_vector.get(i) == chunk) {
-			_chunks_vector.remove(i);
-			break;
-		}
-	}
+	//Dropped data can only be generated again while it's in the world
+	chunk->channels_restore();
+
+	return _chunk_remove(chunk);
+}
+Ref<VoxelChunk> VoxelWorld::_chunk_remove(const Ref<VoxelChunk> &chunk) {
+	int x = chunk->get_position_x();
+	int y = chunk->get_position_y();
+	int z = chunk->get_position_z();
+
+	//Unmapped first, the map doesn't keep it alive
+	bool mapped = _chunks.erase(x, y, z);
+
+	if (_chunks_vector_has(chunk))
+		_chunks_vector_remove(chunk->get_world_index());
+
+	_active_lists_erase(chunk);
 
 	chunk->exit_tree();
 
-	ERR_FAIL_COND_V(!_chunks.erase(pos), NULL);
+	ERR_FAIL_COND_V(!mapped, NULL);
 
-	//_chunks.erase(pos);
+	_streaming_chunk_removed(x, y, z);
 
 	return chunk;
 }
@@ -321,10 +686,15 @@ Ref<VoxelChunk> VoxelWorld::chunk_remove_index(const int index) {
 	ERR_FAIL_INDEX_V(index, _chunks_vector.size(), NULL);
 
 	Ref<VoxelChunk> chunk = _chunks_vector.get(index);
-	_chunks_vector.remove(index);
-	_chunks.erase(IntPos(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z()));
+	chunk->channels_restore();
+
+	_chunks.erase(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z());
+	_chunks_vector_remove(index);
+	_active_lists_erase(chunk);
 	chunk->exit_tree();
 
+	_streaming_chunk_removed(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z());
+
 	return chunk;
 }
 
@@ -338,13 +708,41 @@ int VoxelWorld::chunk_get_count() const {
 }
 
 void VoxelWorld::chunks_clear() {
+	//Workers look chunks up through the map, it can't point to chunks that might get freed below
+	_chunks.clear();
+
 	for (int i = 0; i < _chunks_vector.size(); ++i) {
-		_chunks_vector.get(i)->exit_tree();
+		Ref<VoxelChunk> chunk = _chunks_vector.get(i);
+
+		chunk->exit_tree();
+		chunk->finalize_build_channels();
+		chunk->set_world_index(-1);
+		chunk->set_active_lists(0);
+		_chunk_detach(chunk);
 	}
 
 	_chunks_vector.clear();
 
-	_chunks.clear();
+	_active_process.clear();
+	_active_physics_process.clear();
+	_active_generating.clear();
+	_dirty_chunks.clear();
+
+	for (int i = 0; i < _generation_queue.size(); ++i) {
+		Ref<VoxelChunk> chunk = _generation_queue[i].chunk;
+
+		if (chunk.is_valid())
+			chunk->set_active_lists(chunk->get_active_lists() & ~ACTIVE_LIST_GENERATION_QUEUE);
+	}
+
+	sparse_clear();
+	streaming_reset();
+
+	_region_loading_cancel(false);
+
+#if !THREAD_POOL_PRESENT
+	_sliced_jobs_clear();
+#endif
 
 	_generation_queue.clear();
 	_generating.clear();
@@ -354,6 +752,9 @@ Ref<VoxelChunk> VoxelWorld::chunk_get_or_create(int x, int y, int z) {
 	Ref<VoxelChunk> chunk = chunk_get(x, y, z);
 
 	if (!chunk.is_valid()) {
+		if (_sparse_get(x, y, z) != -1)
+			return _sparse_materialize(x, y, z);
+
 		chunk = chunk_create(x, y, z);
 	}
 
@@ -361,6 +762,9 @@ Ref<VoxelChunk> VoxelWorld::chunk_get_or_create(int x, int y, int z) {
 }
 
 Ref<VoxelChunk> VoxelWorld::chunk_create(const int x, const int y, const int z) {
+	//It's going to be generated again
+	_sparse_erase(x, y, z);
+
 	Ref<VoxelChunk> c = call("_create_chunk", x, y, z, Ref<VoxelChunk>());
 
 	generation_queue_add_to(c);
@@ -394,6 +798,8 @@ Ref<VoxelChunk> VoxelWorld::_create_chunk(const int x, const int y, const int z,
 	chunk->set_position(x, y, z);
 	chunk->set_library(_library);
 	chunk->set_voxel_scale(_voxel_scale);
+	chunk->set_buffer_pool(_buffer_pool);
+	chunk->set_data_layout(_data_layout);
 	chunk->set_size(_chunk_size_x, _chunk_size_y, _chunk_size_z, _data_margin_start, _data_margin_end);
 	//chunk->set_translation(Vector3(x * _chunk_size_x * _voxel_scale, y * _chunk_size_y * _voxel_scale, z * _chunk_size_z * _voxel_scale));
 
@@ -405,122 +811,1203 @@ Ref<VoxelChunk> VoxelWorld::_create_chunk(const int x, const int y, const int z,
 void VoxelWorld::chunk_generate(Ref<VoxelChunk> chunk) {
 	ERR_FAIL_COND(!chunk.is_valid());
 
-	if (has_method("_prepare_chunk_for_generation"))
-		call("_prepare_chunk_for_generation", chunk);
+	_chunk_generate(chunk, PoolByteArray());
+}
+
+void VoxelWorld::chunk_generate_data(Ref<VoxelChunk> chunk) {
+	ERR_FAIL_COND(!chunk.is_valid());
+
+	if (!_world_pack.is_valid() || !_world_pack->chunk_map(chunk)) {
+		if (has_method("_prepare_chunk_for_generation"))
+			call("_prepare_chunk_for_generation", chunk);
+
+		call("_generate_chunk", chunk);
+	}
+
+	//The generated (or shipped) data is the baseline, only changes made from now on need to be saved
+	chunk->set_edit_tracking(true);
+}
+
+void VoxelWorld::_chunk_generate(Ref<VoxelChunk> chunk, const PoolByteArray &delta) {
+	chunk_generate_data(chunk);
+
+	if (delta.size() > 0 && _region_store.is_valid())
+		_region_store->chunk_deserialize(chunk, delta);
 
-	call("_generate_chunk", chunk);
+	if (_sparse_storage && !chunk->get_modified() && _sparse_store(chunk)) {
+		chunk_remove(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z());
+		return;
+	}
 
 	chunk->build();
 }
 
-Vector<Variant> VoxelWorld::chunks_get() {
-	VARIANT_ARRAY_GET(_chunks_vector);
+bool VoxelWorld::chunk_is_sparse(const int x, const int y, const int z) const {
+	return _sparse_get(x, y, z) != -1;
 }
+int VoxelWorld::sparse_get_chunk_count() const {
+	return _sparse_chunk_count;
+}
+int VoxelWorld::sparse_get_run_count() const {
+	return _sparse_run_count;
+}
+PoolIntArray VoxelWorld::sparse_get_positions() const {
+	PoolIntArray positions;
+	positions.resize(_sparse_chunk_count * 3);
 
-void VoxelWorld::chunks_set(const Vector<Variant> &chunks) {
-	if (is_inside_tree()) {
-		for (int i = 0; i < _chunks_vector.size(); ++i) {
-			Ref<VoxelChunk> chunk = Ref<VoxelChunk>(_chunks_vector[i]);
+#if !GODOT4
+	PoolIntArray::Write w = positions.write();
+	int *p = w.ptr();
+#else
+	int *p = positions.ptrw();
+#endif
+
+	int index = 0;
+	const IntPos *key = NULL;
 
-			if (chunks.find(chunk) == -1) {
-				chunk_remove_index(i);
-				_generation_queue.erase(chunk);
-				_generating.erase(chunk);
-				--i;
+	while ((key = _sparse_columns.next(key))) {
+		const Vector<SparseRun> &runs = _sparse_columns.get(*key);
+
+		for (int i = 0; i < runs.size(); ++i) {
+			for (int y = runs[i].y_start; y <= runs[i].y_end; ++y) {
+				ERR_FAIL_COND_V(index + 3 > positions.size(), positions);
+
+				p[index++] = key->x;
+				p[index++] = y;
+				p[index++] = key->z;
 			}
 		}
+	}
 
-		//add the difference
-		for (int i = 0; i < chunks.size(); ++i) {
-			Ref<VoxelChunk> chunk = Ref<VoxelChunk>(chunks[i]);
+	return positions;
+}
+PoolByteArray VoxelWorld::sparse_get_values(const int x, const int y, const int z) const {
+	PoolByteArray arr;
 
-			if (!chunk.is_valid())
-				continue;
+	int value_index = _sparse_get(x, y, z);
 
-			if (_chunks_vector.find(chunk) != -1)
-				continue;
+	if (value_index == -1)
+		return arr;
 
-			chunk_add(chunk, chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z());
-		}
-	} else {
-		_chunks_vector.clear();
+	const Vector<uint8_t> &values = _sparse_values[value_index];
 
-		for (int i = 0; i < chunks.size(); ++i) {
-			Ref<VoxelChunk> chunk = Ref<VoxelChunk>(chunks[i]);
+	arr.resize(values.size());
 
-			_chunks_vector.push_back(chunk);
-		}
+	for (int i = 0; i < values.size(); ++i) {
+		arr.set(i, values[i]);
 	}
-}
 
-int VoxelWorld::_get_channel_index_info(const VoxelWorld::ChannelTypeInfo channel_type) {
-	return -1;
+	return arr;
 }
+int VoxelWorld::sparse_get_memory_usage() const {
+	//Estimate, HashMap elements have a key, a value, and about 2 pointers worth of overhead
+	int size = _sparse_columns.size() * (sizeof(IntPos) + sizeof(Vector<SparseRun>) + sizeof(void *) * 2);
+	size += _sparse_run_count * sizeof(SparseRun);
 
-void VoxelWorld::_set_voxel_with_tool(const bool mode_add, const Vector3 hit_position, const Vector3 hit_normal, const int selected_voxel, const int isolevel) {
-	Vector3 pos;
-
-	if (mode_add) {
-		pos = (hit_position + (Vector3(0.1, 0.1, 0.1) * hit_normal * get_voxel_scale()));
-	} else {
-		pos = (hit_position + (Vector3(0.1, 0.1, 0.1) * -hit_normal * get_voxel_scale()));
+	for (int i = 0; i < _sparse_values.size(); ++i) {
+		size += _sparse_values[i].size();
 	}
 
-	int channel_type = get_channel_index_info(VoxelWorld::CHANNEL_TYPE_INFO_TYPE);
-	int channel_isolevel = get_channel_index_info(VoxelWorld::CHANNEL_TYPE_INFO_ISOLEVEL);
+	return size;
+}
+void VoxelWorld::sparse_clear() {
+	_sparse_columns.clear();
+	_sparse_values.clear();
+	_sparse_chunk_count = 0;
+	_sparse_run_count = 0;
+}
 
-	if (channel_isolevel == -1) {
-		set_voxel_at_world_position(pos, selected_voxel, channel_type);
-	} else {
-		set_voxel_at_world_position(pos, selected_voxel, channel_type, false);
-		set_voxel_at_world_position(pos, isolevel, channel_isolevel);
-	}
+int64_t VoxelWorld::get_memory_usage() const {
+	return sparse_get_memory_usage() + static_cast<int64_t>(_chunks_memory_usage.get());
 }
 
-bool VoxelWorld::can_chunk_do_build_step() {
-	if (_max_frame_chunk_build_steps == 0) {
-		return true;
+PoolByteArray VoxelWorld::compression_dictionary_train(const int max_size) {
+	ERR_FAIL_COND_V(max_size <= 0, PoolByteArray());
+
+	//lz4 can't reference anything further back than 64 KB
+	int size = MIN(max_size, 65536);
+
+	Vector<Ref<VoxelChunk> > chunks;
+
+	for (int i = 0; i < _chunks_vector.size(); ++i) {
+		if (_chunks_vector[i].is_valid())
+			chunks.push_back(_chunks_vector[i]);
 	}
 
-	return _num_frame_chunk_build_steps++ < _max_frame_chunk_build_steps;
-}
+	ERR_FAIL_COND_V_MSG(chunks.size() == 0, PoolByteArray(), "Error, there are no chunks to sample!");
 
-bool VoxelWorld::is_position_walkable(const Vector3 &p_pos) {
-	int x = static_cast<int>(Math::floor(p_pos.x / (_chunk_size_x * _voxel_scale)));
-	int y = static_cast<int>(Math::floor(p_pos.y / (_chunk_size_y * _voxel_scale)));
-	int z = static_cast<int>(Math::floor(p_pos.z / (_chunk_size_z * _voxel_scale)));
+	//Shorter segments than this are not worth much as matches
+	const int min_segment = 256;
 
-	Ref<VoxelChunk> c = chunk_get(x, y, z);
+	int sample_count = MIN(chunks.size(), MAX(size / min_segment, 1));
+	int segment = size / sample_count;
 
-	if (!c.is_valid())
-		return false;
+	PoolByteArray dictionary;
+	dictionary.resize(size);
+
+#if !GODOT4
+	PoolByteArray::Write w = dictionary.write();
+	uint8_t *d = w.ptr();
+#else
+	uint8_t *d = dictionary.ptrw();
+#endif
+
+	int offset = 0;
+
+	for (int i = 0; i < sample_count; ++i) {
+		//Spread the samples over the world, and over the channels
+		const Ref<VoxelChunk> &chunk = chunks[i * chunks.size() / sample_count];
+
+		PoolByteArray raw = chunk->data_serialize(false);
+
+		int len = MIN(segment, raw.size());
+		int start = raw.size() > segment ? (i * segment) % (raw.size() - segment) : 0;
+
+#if !GODOT4
+		PoolByteArray::Read r = raw.read();
+		memcpy(d + offset, r.ptr() + start, len);
+#else
+		memcpy(d + offset, raw.ptr() + start, len);
+#endif
+
+		offset += len;
+	}
+
+#if !GODOT4
+	w.release();
+#endif
+
+	dictionary.resize(offset);
+
+	set_compression_dictionary(dictionary);
+
+	return dictionary;
+}
+
+int VoxelWorld::memory_budget_enforce() {
+	if (_memory_budget <= 0)
+		return 0;
+
+	int64_t used = get_memory_usage();
+
+	if (used <= _memory_budget)
+		return 0;
+
+	int evicted = 0;
+
+	SelfList<VoxelChunk> *e = _chunks_lru.first();
+
+	while (e && used > _memory_budget) {
+		VoxelChunk *chunk = e->self();
+		e = e->next();
+
+		if (!_memory_budget_can_evict(chunk))
+			continue;
+
+		int64_t memory = chunk->get_memory_usage();
+
+		if (memory == 0)
+			continue;
+
+		//Untouched generated data can just be generated again, no need to keep a compressed copy
+		bool success = _chunk_is_regenerable(chunk) ? chunk->channels_drop() : chunk->channels_evict();
+
+		if (!success)
+			continue;
+
+		used += chunk->get_memory_usage() - memory;
+		++evicted;
+	}
+
+	//Nothing else can be evicted, until chunks get added, or the player moves
+	_memory_budget_stalled = evicted == 0 && used > _memory_budget;
+
+	return evicted;
+}
+bool VoxelWorld::_memory_budget_can_evict(VoxelChunk *chunk) const {
+	if (chunk->get_is_generating() || chunk->snapshot_is_active() || chunk->channels_is_evicted())
+		return false;
+
+	//Hidden chunks, and worlds without a player only go by the access order
+	if (!chunk->get_visible() || !_generation_has_view)
+		return true;
+
+	//Chunks inside the spawn range are meshed, and edited all the time
+	return !_streaming_in_range(chunk->get_position_x() - _generation_center.x, chunk->get_position_y() - _generation_center.y, chunk->get_position_z() - _generation_center.z, 0);
+}
+
+void VoxelWorld::streaming_update() {
+	if (!get_player() || !INSTANCE_VALIDATE(get_player()))
+		return;
+
+	if (_streaming_offsets_dirty)
+		_streaming_build_offsets();
+
+	Vector3 ppos = get_player()->get_transform().origin / get_voxel_scale();
+
+	//Note: floor is needed to handle negative numbers properly
+	IntPos center(
+			static_cast<int>(Math::floor(ppos.x / _chunk_size_x)),
+			static_cast<int>(Math::floor(ppos.y / _chunk_size_y)),
+			static_cast<int>(Math::floor(ppos.z / _chunk_size_z)));
+
+	if (!_streaming_has_center) {
+		//The ranges might have changed, everything that's loaded needs to be checked once
+		Vector<IntPos> leaving;
+
+		for (int i = 0; i < _chunks_vector.size(); ++i) {
+			const Ref<VoxelChunk> &chunk = _chunks_vector[i];
+			IntPos pos(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z());
+
+			if (!_streaming_in_range(pos.x - center.x, pos.y - center.y, pos.z - center.z, _chunk_despawn_margin))
+				leaving.push_back(pos);
+		}
+
+		for (int i = 0; i < leaving.size(); ++i) {
+			if (!_streaming_unload(leaving[i]))
+				_streaming_unload_pending.push_back(leaving[i]);
+		}
+
+		_streaming_center = center;
+		_streaming_has_center = true;
+		_streaming_walk_shell = false;
+		_streaming_cursor = 0;
+	} else if (!(center == _streaming_center)) {
+		IntPos previous = _streaming_center;
+
+		//Every chunk that leaves, or enters the range is on the edge of it, as long as the center only moved to a neighbour
+		bool step = ABS(center.x - previous.x) <= 1 && ABS(center.y - previous.y) <= 1 && ABS(center.z - previous.z) <= 1;
+
+		if (step) {
+			for (int i = 0; i < _streaming_despawn_shell.size(); ++i) {
+				const IntPos &offset = _streaming_despawn_shell[i];
+				IntPos pos(previous.x + offset.x, previous.y + offset.y, previous.z + offset.z);
+
+				if (_streaming_in_range(pos.x - center.x, pos.y - center.y, pos.z - center.z, _chunk_despawn_margin))
+					continue;
+
+				if (!_streaming_unload(pos))
+					_streaming_unload_pending.push_back(pos);
+			}
+		} else {
+			int r = _chunk_spawn_range + _chunk_despawn_margin;
+			int ry = (_streaming_shape == STREAMING_SHAPE_CYLINDER ? _chunk_spawn_range_y : _chunk_spawn_range) + _chunk_despawn_margin;
+
+			for (int x = -r; x <= r; ++x) {
+				for (int z = -r; z <= r; ++z) {
+					for (int y = -ry; y <= ry; ++y) {
+						if (!_streaming_in_range(x, y, z, _chunk_despawn_margin))
+							continue;
+
+						IntPos pos(previous.x + x, previous.y + y, previous.z + z);
+
+						if (_streaming_in_range(pos.x - center.x, pos.y - center.y, pos.z - center.z, _chunk_despawn_margin))
+							continue;
+
+						if (!_streaming_unload(pos))
+							_streaming_unload_pending.push_back(pos);
+					}
+				}
+			}
+		}
+
+		//An unfinished walk might have left holes anywhere, so only the shell is enough if the last one got to the end
+		_streaming_walk_shell = step && _streaming_cursor >= (_streaming_walk_shell ? _streaming_spawn_shell.size() : _streaming_offsets.size());
+		_streaming_center = center;
+		_streaming_cursor = 0;
+	}
+
+	for (int i = 0; i < _streaming_unload_pending.size();) {
+		const IntPos &pos = _streaming_unload_pending[i];
+
+		if (_streaming_in_range(pos.x - center.x, pos.y - center.y, pos.z - center.z, _chunk_despawn_margin) || _streaming_unload(pos)) {
+			int last = _streaming_unload_pending.size() - 1;
+
+			_streaming_unload_pending.set(i, _streaming_unload_pending[last]);
+			_streaming_unload_pending.resize(last);
+			continue;
+		}
+
+		++i;
+	}
+
+	//Chunks that were removed inside the range by something else
+	while (_streaming_refill.size() > 0 && _generation_queue.size() < _max_concurrent_generations) {
+		int last = _streaming_refill.size() - 1;
+		IntPos pos = _streaming_refill[last];
+		_streaming_refill.resize(last);
+
+		if (!_streaming_in_range(pos.x - center.x, pos.y - center.y, pos.z - center.z, 0))
+			continue;
+
+		if (_chunks.has(pos.x, pos.y, pos.z) || _sparse_get(pos.x, pos.y, pos.z) != -1)
+			continue;
+
+		chunk_create(pos.x, pos.y, pos.z);
+	}
+
+	//Nearest first, the generation queue throttles how many chunks get created per frame
+	const Vector<IntPos> &offsets = _streaming_walk_shell ? _streaming_spawn_shell : _streaming_offsets;
+
+	while (_streaming_cursor < offsets.size() && _generation_queue.size() < _max_concurrent_generations) {
+		const IntPos &offset = offsets[_streaming_cursor++];
+
+		int x = center.x + offset.x;
+		int y = center.y + offset.y;
+		int z = center.z + offset.z;
+
+		if (_chunks.has(x, y, z) || _sparse_get(x, y, z) != -1)
+			continue;
+
+		chunk_create(x, y, z);
+	}
+}
+void VoxelWorld::streaming_reset() {
+	_streaming_offsets_dirty = true;
+	_streaming_has_center = false;
+	_streaming_walk_shell = false;
+	_streaming_cursor = 0;
+	_streaming_unload_pending.clear();
+	_streaming_refill.clear();
+}
+
+int VoxelWorld::region_store_save() {
+	ERR_FAIL_COND_V(!_region_store.is_valid(), 0);
+	ERR_FAIL_COND_V_MSG(!_region_store->is_open(), 0, "Error, set the region store's directory first!");
+
+	int count = 0;
+
+	for (int i = 0; i < _chunks_vector.size(); ++i) {
+		Ref<VoxelChunk> chunk = _chunks_vector[i];
+
+		if (!chunk->get_modified() || chunk->get_is_generating() || (chunk->get_active_lists() & (ACTIVE_LIST_GENERATION_QUEUE | ACTIVE_LIST_REGION_LOADING)))
+			continue;
+
+		_region_store->save_chunk(chunk);
+		++count;
+	}
+
+	return count;
+}
+
+void VoxelWorld::_region_store_poll() {
+	int x;
+	int y;
+	int z;
+	PoolByteArray data;
+
+	while (_region_store->load_poll(x, y, z, data)) {
+		IntPos pos(x, y, z);
+		RegionLoad *load = _region_loading.getptr(pos);
+
+		if (!load)
+			continue;
+
+		//Older requests were made for chunks that got removed since, the data might have changed after them
+		if (--load->requests > 0)
+			continue;
+
+		Ref<VoxelChunk> chunk = load->chunk;
+		_region_loading.erase(pos);
+
+		if (!chunk.is_valid())
+			continue;
+
+		chunk->set_active_lists(chunk->get_active_lists() & ~ACTIVE_LIST_REGION_LOADING);
+
+		//Cancelled
+		if (chunk->get_voxel_world() != this)
+			continue;
+
+		_generating.push_back(chunk);
+
+		//Deltas need the generated baseline first
+		if (_region_store->data_is_delta(data)) {
+			_chunk_generate(chunk, data);
+			continue;
+		}
+
+		if (data.size() > 0 && _region_store->chunk_deserialize(chunk, data)) {
+			chunk->build();
+			continue;
+		}
+
+		chunk_generate(chunk);
+	}
+}
+void VoxelWorld::_region_loading_cancel(const bool forget) {
+	Vector<Ref<VoxelChunk> > requeue;
+
+	const IntPos *key = NULL;
+
+	while ((key = _region_loading.next(key))) {
+		RegionLoad &load = _region_loading[*key];
+
+		if (!load.chunk.is_valid())
+			continue;
+
+		load.chunk->set_active_lists(load.chunk->get_active_lists() & ~ACTIVE_LIST_REGION_LOADING);
+
+		if (forget && load.chunk->get_voxel_world() == this)
+			requeue.push_back(load.chunk);
+
+		load.chunk.unref();
+	}
+
+	//Otherwise the entries stay until their results arrive, so they can't be mistaken for newer requests' results
+	if (forget)
+		_region_loading.clear();
+
+	for (int i = 0; i < requeue.size(); ++i)
+		generation_queue_add_to(requeue[i]);
+}
+
+void VoxelWorld::_streaming_build_offsets() {
+	_streaming_offsets_dirty = false;
+	_streaming_offsets.clear();
+	_streaming_spawn_shell.clear();
+	_streaming_despawn_shell.clear();
+
+	//Spawn range first, then the despawn range. They are the same without a margin.
+	for (int margin = 0; margin <= _chunk_despawn_margin; margin += MAX(_chunk_despawn_margin, 1)) {
+		int r = _chunk_spawn_range + margin;
+		int ry = (_streaming_shape == STREAMING_SHAPE_CYLINDER ? _chunk_spawn_range_y : _chunk_spawn_range) + margin;
+
+		for (int x = -r; x <= r; ++x) {
+			for (int z = -r; z <= r; ++z) {
+				for (int y = -ry; y <= ry; ++y) {
+					if (!_streaming_in_range(x, y, z, margin))
+						continue;
+
+					IntPos pos(x, y, z);
+
+					if (margin == 0)
+						_streaming_offsets.push_back(pos);
+
+					//On the edge, if any of it's 26 neighbours is outside
+					bool edge = false;
+
+					for (int i = 0; i < 27 && !edge; ++i) {
+						edge = !_streaming_in_range(x + i % 3 - 1, y + (i / 3) % 3 - 1, z + i / 9 - 1, margin);
+					}
+
+					if (!edge)
+						continue;
+
+					if (margin == 0)
+						_streaming_spawn_shell.push_back(pos);
+
+					if (margin == _chunk_despawn_margin)
+						_streaming_despawn_shell.push_back(pos);
+				}
+			}
+		}
+	}
+
+	_streaming_offsets.sort_custom<IntPosDistanceComparator>();
+	_streaming_spawn_shell.sort_custom<IntPosDistanceComparator>();
+}
+bool VoxelWorld::_streaming_in_range(const int dx, const int dy, const int dz, const int margin) const {
+	int r = _chunk_spawn_range + margin;
+
+	if (_streaming_shape == STREAMING_SHAPE_CYLINDER)
+		return dx * dx + dz * dz <= r * r && ABS(dy) <= _chunk_spawn_range_y + margin;
+
+	return dx * dx + dy * dy + dz * dz <= r * r;
+}
+//Streaming only looks at the edge of the range when the player moves, so holes made by others get remembered
+void VoxelWorld::_streaming_chunk_removed(const int x, const int y, const int z) {
+	if (!_streaming || !_streaming_has_center)
+		return;
+
+	if (_streaming_in_range(x - _streaming_center.x, y - _streaming_center.y, z - _streaming_center.z, 0))
+		_streaming_refill.push_back(IntPos(x, y, z));
+}
+bool VoxelWorld::_streaming_unload(const IntPos &pos) {
+	_sparse_erase(pos.x, pos.y, pos.z);
+
+	VoxelChunk *c = _chunks.getptr(pos.x, pos.y, pos.z);
+
+	if (!c)
+		return true;
+
+	Ref<VoxelChunk> chunk = Ref<VoxelChunk>(c);
+
+	//Jobs might still use it
+	if (chunk->get_is_generating())
+		return false;
+
+	_generating.erase(chunk);
+
+	//Chunks that are still waiting for their data have nothing to save, untouched generated chunks can be generated again
+	if (_region_store.is_valid() && _region_store->is_open() && chunk->get_modified() && !(chunk->get_active_lists() & (ACTIVE_LIST_GENERATION_QUEUE | ACTIVE_LIST_REGION_LOADING)))
+		_region_store->save_chunk(chunk);
+
+	//It's thrown away, dropped data doesn't need to be generated again
+	_chunk_remove(chunk);
+
+	//It's dropped from the generation queue when that gets rebuilt, or reaches it
+	chunk->set_voxel_world(NULL);
+
+	return true;
+}
+
+bool VoxelWorld::_sparse_store(const Ref<VoxelChunk> &chunk) {
+	ERR_FAIL_COND_V(!chunk.is_valid(), false);
+
+	if (chunk->voxel_structure_get_count() > 0)
+		return false;
+
+#if PROPS_PRESENT
+	if (chunk->prop_get_count() > 0)
+		return false;
+#endif
+
+#if MESH_DATA_RESOURCE_PRESENT
+	if (chunk->mesh_data_resource_get_count() > 0)
+		return false;
+#endif
+
+	int count = chunk->channel_get_count();
+
+	//Only 8 bit values are stored, a collapsed channel can still have it's high bytes
+	for (int i = 0; i < count; ++i) {
+		if (!chunk->channel_collapse(i) || !chunk->channel_is_uniform(i))
+			return false;
+	}
+
+	Vector<uint8_t> values;
+	values.resize(count);
+
+	for (int i = 0; i < count; ++i) {
+		values.write[i] = chunk->get_voxel(0, 0, 0, i);
+	}
+
+	//A solid chunk still needs it's faces towards it's neighbours, unless the margins show that they are solid too
+	int channel_type = get_channel_index_info(VoxelWorld::CHANNEL_TYPE_INFO_TYPE);
+	bool empty = channel_type >= 0 && channel_type < count && values[channel_type] == 0;
+
+	if (!empty && (chunk->get_margin_start() == 0 || chunk->get_margin_end() == 0))
+		return false;
+
+	int value_index = -1;
+
+	for (int i = 0; i < _sparse_values.size() && value_index == -1; ++i) {
+		const Vector<uint8_t> &v = _sparse_values[i];
+
+		if (v.size() != count)
+			continue;
+
+		value_index = i;
+
+		for (int j = 0; j < count; ++j) {
+			if (v[j] != values[j]) {
+				value_index = -1;
+				break;
+			}
+		}
+	}
+
+	if (value_index == -1) {
+		value_index = _sparse_values.size();
+		_sparse_values.push_back(values);
+	}
+
+	_sparse_set(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z(), value_index);
+
+	return true;
+}
+
+int VoxelWorld::_sparse_get(const int x, const int y, const int z) const {
+	const Vector<SparseRun> *runs = _sparse_columns.getptr(IntPos(x, 0, z));
+
+	if (!runs)
+		return -1;
+
+	for (int i = 0; i < runs->size(); ++i) {
+		const SparseRun &run = (*runs)[i];
+
+		if (y < run.y_start)
+			return -1;
+
+		if (y <= run.y_end)
+			return run.value_index;
+	}
+
+	return -1;
+}
+
+void VoxelWorld::_sparse_set(const int x, const int y, const int z, const int value_index) {
+	_sparse_erase(x, y, z);
+
+	IntPos pos(x, 0, z);
+
+	if (!_sparse_columns.has(pos))
+		_sparse_columns.set(pos, Vector<SparseRun>());
+
+	Vector<SparseRun> &runs = _sparse_columns[pos];
+
+	int index = 0;
+
+	while (index < runs.size() && runs[index].y_start < y)
+		++index;
+
+	bool merge_prev = index > 0 && runs[index - 1].y_end == y - 1 && runs[index - 1].value_index == value_index;
+	bool merge_next = index < runs.size() && runs[index].y_start == y + 1 && runs[index].value_index == value_index;
+
+	if (merge_prev && merge_next) {
+		runs.write[index - 1].y_end = runs[index].y_end;
+		runs.remove(index);
+		--_sparse_run_count;
+	} else if (merge_prev) {
+		runs.write[index - 1].y_end = y;
+	} else if (merge_next) {
+		runs.write[index].y_start = y;
+	} else {
+		SparseRun run;
+		run.y_start = y;
+		run.y_end = y;
+		run.value_index = value_index;
+
+		runs.insert(index, run);
+		++_sparse_run_count;
+	}
+
+	++_sparse_chunk_count;
+}
+
+void VoxelWorld::_sparse_erase(const int x, const int y, const int z) {
+	IntPos pos(x, 0, z);
+
+	Vector<SparseRun> *runs = _sparse_columns.getptr(pos);
+
+	if (!runs)
+		return;
+
+	for (int i = 0; i < runs->size(); ++i) {
+		SparseRun run = (*runs)[i];
+
+		if (y < run.y_start)
+			return;
+
+		if (y > run.y_end)
+			continue;
+
+		if (run.y_start == run.y_end) {
+			runs->remove(i);
+			--_sparse_run_count;
+		} else if (y == run.y_start) {
+			runs->write[i].y_start = y + 1;
+		} else if (y == run.y_end) {
+			runs->write[i].y_end = y - 1;
+		} else {
+			SparseRun upper = run;
+			upper.y_start = y + 1;
+
+			runs->write[i].y_end = y - 1;
+			runs->insert(i + 1, upper);
+			++_sparse_run_count;
+		}
+
+		--_sparse_chunk_count;
+
+#if VERSION_MAJOR > 3
+		if (runs->is_empty())
+#else
+		if (runs->empty())
+#endif
+			_sparse_columns.erase(pos);
+
+		return;
+	}
+}
+
+Ref<VoxelChunk> VoxelWorld::_sparse_materialize(const int x, const int y, const int z) {
+	int value_index = _sparse_get(x, y, z);
+
+	ERR_FAIL_COND_V(value_index == -1, Ref<VoxelChunk>());
+
+	_sparse_erase(x, y, z);
+
+	Ref<VoxelChunk> chunk = call("_create_chunk", x, y, z, Ref<VoxelChunk>());
+
+	ERR_FAIL_COND_V(!chunk.is_valid(), Ref<VoxelChunk>());
+
+	const Vector<uint8_t> &values = _sparse_values[value_index];
+	int count = MIN(values.size(), chunk->channel_get_count());
+
+	for (int i = 0; i < count; ++i) {
+		chunk->channel_fill(values[i], i);
+	}
+
+	//Same as the generator's output
+	chunk->set_edit_tracking(true);
+
+	return chunk;
+}
+
+Vector<Variant> VoxelWorld::chunks_get() {
+	VARIANT_ARRAY_GET(_chunks_vector);
+}
+
+void VoxelWorld::chunks_set(const Vector<Variant> &chunks) {
+	if (is_inside_tree()) {
+		//Mark the chunks that stay using their indices
+		Vector<bool> keep;
+		keep.resize(_chunks_vector.size());
+
+		for (int i = 0; i < keep.size(); ++i) {
+			keep.write[i] = false;
+		}
+
+		for (int i = 0; i < chunks.size(); ++i) {
+			Ref<VoxelChunk> chunk = Ref<VoxelChunk>(chunks[i]);
+
+			if (chunk.is_valid() && _chunks_vector_has(chunk))
+				keep.write[chunk->get_world_index()] = true;
+		}
+
+		//Going backwards, swap removal only moves chunks that were already checked
+		for (int i = _chunks_vector.size() - 1; i >= 0; --i) {
+			if (keep[i])
+				continue;
+
+			Ref<VoxelChunk> chunk = chunk_remove_index(i);
+			_generating.erase(chunk);
+
+			//It's dropped from the generation queue when that gets rebuilt, or reaches it
+			if (!chunk->get_is_generating())
+				chunk->set_voxel_world(NULL);
+		}
+
+		//add the difference
+		for (int i = 0; i < chunks.size(); ++i) {
+			Ref<VoxelChunk> chunk = Ref<VoxelChunk>(chunks[i]);
+
+			if (!chunk.is_valid())
+				continue;
+
+			if (_chunks_vector_has(chunk))
+				continue;
+
+			chunk_add(chunk, chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z());
+		}
+	} else {
+		//The map only has raw pointers, the old chunks might get freed below
+		_chunks.clear();
+
+		for (int i = 0; i < _chunks_vector.size(); ++i) {
+			Ref<VoxelChunk> chunk = _chunks_vector.get(i);
+
+			_active_lists_erase(chunk);
+			chunk->set_world_index(-1);
+			_chunk_detach(chunk);
+		}
+
+		_chunks_vector.clear();
+
+		for (int i = 0; i < chunks.size(); ++i) {
+			Ref<VoxelChunk> chunk = Ref<VoxelChunk>(chunks[i]);
+
+			if (!chunk.is_valid())
+				continue;
+
+			if (!_chunks.has(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z()))
+				_chunks.set(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z(), chunk.ptr());
+
+			chunk->set_world_index(_chunks_vector.size());
+			_chunks_vector.push_back(chunk);
+			_chunk_attach(chunk);
+		}
+	}
+}
+
+bool VoxelWorld::_chunks_vector_has(const Ref<VoxelChunk> &chunk) const {
+	int index = chunk->get_world_index();
+
+	return index >= 0 && index < _chunks_vector.size() && _chunks_vector[index] == chunk;
+}
+void VoxelWorld::active_process_add(VoxelChunk *chunk) {
+	_active_list_add(_active_process, chunk, ACTIVE_LIST_PROCESS);
+}
+void VoxelWorld::active_physics_process_add(VoxelChunk *chunk) {
+	_active_list_add(_active_physics_process, chunk, ACTIVE_LIST_PHYSICS_PROCESS);
+}
+void VoxelWorld::active_generating_add(VoxelChunk *chunk) {
+	_active_list_add(_active_generating, chunk, ACTIVE_LIST_GENERATING);
+}
+
+void VoxelWorld::chunk_mark_dirty(const Ref<VoxelChunk> &chunk) {
+	ERR_FAIL_COND(!chunk.is_valid());
+
+	_active_list_add(_dirty_chunks, chunk.ptr(), ACTIVE_LIST_DIRTY);
+}
+int VoxelWorld::dirty_get_count() const {
+	return _dirty_chunks.size();
+}
+void VoxelWorld::dirty_flush() {
+	_dirty_flush_timer = 0;
+
+	for (int i = 0; i < _dirty_chunks.size(); ++i) {
+		Ref<VoxelChunk> chunk = _dirty_chunks[i];
+
+		//A running build would only queue a second one, so it gets rebuilt after that finished
+		if (chunk->get_is_generating())
+			continue;
+
+		_active_list_remove(_dirty_chunks, i, ACTIVE_LIST_DIRTY);
+		--i;
+
+		//Generation will build it anyway
+		if (chunk->get_active_lists() & ACTIVE_LIST_GENERATION_QUEUE)
+			continue;
+
+		if (!chunk->is_in_tree() || !is_inside_tree())
+			continue;
+
+		chunk->build();
+	}
+}
+
+void VoxelWorld::_active_list_add(Vector<Ref<VoxelChunk> > &list, VoxelChunk *chunk, const int flag) {
+	ERR_FAIL_COND(!chunk);
+
+	if (chunk->get_active_lists() & flag)
+		return;
+
+	Ref<VoxelChunk> c(chunk);
+
+	//chunk_add() will add it
+	if (!_chunks_vector_has(c))
+		return;
+
+	chunk->set_active_lists(chunk->get_active_lists() | flag);
+	chunk->set_active_list_index(_active_list_slot(flag), list.size());
+	list.push_back(c);
+}
+void VoxelWorld::_active_list_remove(Vector<Ref<VoxelChunk> > &list, const int index, const int flag) {
+	ERR_FAIL_INDEX(index, list.size());
+
+	Ref<VoxelChunk> chunk = list[index];
+	int slot = _active_list_slot(flag);
+
+	chunk->set_active_lists(chunk->get_active_lists() & ~flag);
+	chunk->set_active_list_index(slot, -1);
+
+	int last = list.size() - 1;
+
+	if (index != last) {
+		Ref<VoxelChunk> moved = list[last];
+		moved->set_active_list_index(slot, index);
+		list.set(index, moved);
+	}
+
+	list.resize(last);
+}
+void VoxelWorld::_active_list_erase(Vector<Ref<VoxelChunk> > &list, const Ref<VoxelChunk> &chunk, const int flag) {
+	int index = chunk->get_active_list_index(_active_list_slot(flag));
+
+	ERR_FAIL_COND(index < 0 || index >= list.size() || list[index] != chunk);
+
+	_active_list_remove(list, index, flag);
+}
+void VoxelWorld::_active_lists_erase(const Ref<VoxelChunk> &chunk) {
+	int lists = chunk->get_active_lists();
+
+	if (lists & ACTIVE_LIST_PROCESS)
+		_active_list_erase(_active_process, chunk, ACTIVE_LIST_PROCESS);
+
+	if (lists & ACTIVE_LIST_PHYSICS_PROCESS)
+		_active_list_erase(_active_physics_process, chunk, ACTIVE_LIST_PHYSICS_PROCESS);
+
+	if (lists & ACTIVE_LIST_GENERATING) {
+		_active_list_erase(_active_generating, chunk, ACTIVE_LIST_GENERATING);
+
+		//The frame loops won't see it anymore, does nothing if the build is still running
+		chunk->finalize_build_channels();
+	}
+
+	if (lists & ACTIVE_LIST_DIRTY)
+		_active_list_erase(_dirty_chunks, chunk, ACTIVE_LIST_DIRTY);
+}
+
+void VoxelWorld::_chunks_vector_remove(const int index) {
+	int last = _chunks_vector.size() - 1;
+
+	_chunks_vector.get(index)->set_world_index(-1);
+	_chunk_detach(_chunks_vector.get(index));
+
+	if (index != last) {
+		Ref<VoxelChunk> moved = _chunks_vector.get(last);
+		moved->set_world_index(index);
+		_chunks_vector.set(index, moved);
+	}
+
+	_chunks_vector.resize(last);
+}
+
+void VoxelWorld::_chunk_attach(const Ref<VoxelChunk> &chunk) {
+	chunk->memory_usage_attach(&_chunks_memory_usage);
+	_chunks_lru.add_last(chunk->lru_get_item());
+	_memory_budget_stalled = false;
+}
+void VoxelWorld::_chunk_detach(const Ref<VoxelChunk> &chunk) {
+	//The map doesn't hold a reference, the chunk can be freed after this
+	ERR_FAIL_COND_MSG(_chunks.getptr(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z()) == chunk.ptr(), "Error, a chunk was released while it's still in the chunk map!");
+
+	chunk->memory_usage_attach(NULL);
+
+	if (chunk->lru_get_item()->in_list())
+		_chunks_lru.remove(chunk->lru_get_item());
+}
+bool VoxelWorld::_chunk_is_regenerable(VoxelChunk *chunk) const {
+	//Generation would add these again
+	if (chunk->voxel_structure_get_count() > 0)
+		return false;
+
+#if PROPS_PRESENT
+	if (chunk->prop_get_count() > 0)
+		return false;
+#endif
+
+#if MESH_DATA_RESOURCE_PRESENT
+	if (chunk->mesh_data_resource_get_count() > 0)
+		return false;
+#endif
+
+	return chunk->get_edit_tracking() && !chunk->get_modified();
+}
+
+int VoxelWorld::_get_channel_index_info(const VoxelWorld::ChannelTypeInfo channel_type) {
+	return -1;
+}
+
+void VoxelWorld::_set_voxel_with_tool(const bool mode_add, const Vector3 hit_position, const Vector3 hit_normal, const int selected_voxel, const int isolevel) {
+	Vector3 pos;
+
+	if (mode_add) {
+		pos = (hit_position + (Vector3(0.1, 0.1, 0.1) * hit_normal * get_voxel_scale()));
+	} else {
+		pos = (hit_position + (Vector3(0.1, 0.1, 0.1) * -hit_normal * get_voxel_scale()));
+	}
+
+	int channel_type = get_channel_index_info(VoxelWorld::CHANNEL_TYPE_INFO_TYPE);
+	int channel_isolevel = get_channel_index_info(VoxelWorld::CHANNEL_TYPE_INFO_ISOLEVEL);
+
+	if (channel_isolevel == -1) {
+		set_voxel_at_world_position(pos, selected_voxel, channel_type);
+	} else {
+		set_voxel_at_world_position(pos, selected_voxel, channel_type, false);
+		set_voxel_at_world_position(pos, isolevel, channel_isolevel);
+	}
+}
+
+bool VoxelWorld::can_chunk_do_build_step() {
+	if (_max_frame_chunk_build_steps == 0) {
+		return true;
+	}
+
+	return _num_frame_chunk_build_steps++ < _max_frame_chunk_build_steps;
+}
+
+bool VoxelWorld::is_position_walkable(const Vector3 &p_pos) {
+	int x = static_cast<int>(Math::floor(p_pos.x / (_chunk_size_x * _voxel_scale)));
+	int y = static_cast<int>(Math::floor(p_pos.y / (_chunk_size_y * _voxel_scale)));
+	int z = static_cast<int>(Math::floor(p_pos.z / (_chunk_size_z * _voxel_scale)));
+
+	Ref<VoxelChunk> c = chunk_get(x, y, z);
+
+	if (!c.is_valid())
+		return false;
+
+	return !c->get_is_generating();
+}
+
+void VoxelWorld::on_chunk_mesh_generation_finished(Ref<VoxelChunk> p_chunk) {
+	call_deferred("emit_signal", "chunk_mesh_generation_finished", p_chunk);
+}
+
+void VoxelWorld::generation_queue_add_to(const Ref<VoxelChunk> &chunk) {
+	ERR_FAIL_COND(!chunk.is_valid());
+
+	set_process_internal(true);
+
+	GenerationQueueEntry entry;
+	entry.chunk = chunk;
+	entry.priority = _generation_get_priority(chunk);
+	entry.sequence = _generation_queue_sequence++;
+
+	chunk->set_active_lists(chunk->get_active_lists() | ACTIVE_LIST_GENERATION_QUEUE);
+
+	_generation_queue.push_back(entry);
+	_generation_queue_sift_up(_generation_queue.size() - 1);
+}
+Ref<VoxelChunk> VoxelWorld::generation_queue_get_index(int index) {
+	ERR_FAIL_INDEX_V(index, _generation_queue.size(), NULL);
+
+	return _generation_queue[index].chunk;
+}
+void VoxelWorld::generation_queue_remove_index(int index) {
+	ERR_FAIL_INDEX(index, _generation_queue.size());
+
+	_generation_queue_remove(index);
+}
+int VoxelWorld::generation_queue_get_size() const {
+	return _generation_queue.size();
+}
+void VoxelWorld::generation_queue_update_priorities() {
+	_generation_update_view();
+	_generation_queue_rebuild();
+}
+
+bool VoxelWorld::_generation_update_view() {
+	if (!get_player() || !INSTANCE_VALIDATE(get_player())) {
+		bool changed = _generation_has_view;
+		_generation_has_view = false;
+
+		return changed;
+	}
+
+	Transform t = get_player()->get_transform();
+	Vector3 ppos = t.origin / get_voxel_scale();
+
+	IntPos center(
+			static_cast<int>(Math::floor(ppos.x / _chunk_size_x)),
+			static_cast<int>(Math::floor(ppos.y / _chunk_size_y)),
+			static_cast<int>(Math::floor(ppos.z / _chunk_size_z)));
+
+	Vector3 forward = t.basis.xform(Vector3(0, 0, -1)).normalized();
+
+	//Small turns don't change the order much, so they don't trigger a rebuild
+	if (_generation_has_view && center == _generation_center && forward.dot(_generation_forward) > 0.9)
+		return false;
+
+	_generation_has_view = true;
+	_generation_center = center;
+	_generation_forward = forward;
+
+	//Different chunks are outside of the spawn range now
+	_memory_budget_stalled = false;
+
+	return true;
+}
+float VoxelWorld::_generation_get_priority(const Ref<VoxelChunk> &chunk) const {
+	if (!_generation_has_view)
+		return 0;
+
+	Vector3 d(chunk->get_position_x() - _generation_center.x, chunk->get_position_y() - _generation_center.y, chunk->get_position_z() - _generation_center.z);
+
+	float distance = d.length_squared();
+
+	if (distance == 0)
+		return 0;
+
+	//Chunks behind the player count as twice as far
+	float facing = d.normalized().dot(_generation_forward);
+
+	return distance * (1.5 - facing * 0.5);
+}
+#if !THREAD_POOL_PRESENT
+void VoxelWorld::_sliced_jobs_process() {
+	uint64_t start = OS::get_singleton()->get_ticks_usec();
+	uint64_t deadline = start + static_cast<uint64_t>(_job_frame_budget * 1000.0);
+
+	//Jobs that are added while this runs (next jobs of chunks) can still use the rest of the budget
+	while (_sliced_jobs.size() > 0 && OS::get_singleton()->get_ticks_usec() < deadline) {
+		Ref<VoxelJob> job = _sliced_jobs[0].job;
+
+		int last = _sliced_jobs.size() - 1;
+
+		if (last != 0) {
+			SlicedJobEntry entry = _sliced_jobs[last];
+			_sliced_jobs.set(0, entry);
+		}
+
+		_sliced_jobs.resize(last);
+		heap_sift_down(_sliced_jobs.ptrw(), last, 0);
+
+		job->set_deadline(deadline);
+		job->execute();
+		job->set_deadline(0);
+
+		//Jobs mark themselves complete, yielded ones get queued again
+		if (job->should_continue())
+			job_sliced_add(job);
+	}
+}
+void VoxelWorld::_sliced_jobs_clear() {
+	for (int i = 0; i < _sliced_jobs.size(); ++i) {
+		Ref<VoxelJob> job = _sliced_jobs[i].job;
+
+		//Executing a job that left the tree only releases it's chunk, otherwise they'd keep each other alive
+		job->chunk_exit_tree();
+		job->execute();
+	}
+
+	_sliced_jobs.clear();
+}
+#endif
+
+void VoxelWorld::_generation_queue_rebuild() {
+	int count = 0;
+	GenerationQueueEntry *q = _generation_queue.ptrw();
+
+	for (int i = 0; i < _generation_queue.size(); ++i) {
+		//Cancelled chunks get dropped here
+		if (!q[i].chunk.is_valid())
+			continue;
+
+		if (q[i].chunk->get_voxel_world() != this) {
+			q[i].chunk->set_active_lists(q[i].chunk->get_active_lists() & ~ACTIVE_LIST_GENERATION_QUEUE);
+			continue;
+		}
+
+		q[i].priority = _generation_get_priority(q[i].chunk);
+
+		if (count != i)
+			q[count] = q[i];
+
+		++count;
+	}
+
+	_generation_queue.resize(count);
 
-	return !c->get_is_generating();
+	for (int i = count / 2 - 1; i >= 0; --i) {
+		_generation_queue_sift_down(i);
+	}
 }
+Ref<VoxelChunk> VoxelWorld::_generation_queue_pop() {
+	Ref<VoxelChunk> chunk = _generation_queue[0].chunk;
 
-void VoxelWorld::on_chunk_mesh_generation_finished(Ref<VoxelChunk> p_chunk) {
-	call_deferred("emit_signal", "chunk_mesh_generation_finished", p_chunk);
+	_generation_queue_remove(0);
+
+	return chunk;
 }
+void VoxelWorld::_generation_queue_remove(const int index) {
+	Ref<VoxelChunk> chunk = _generation_queue[index].chunk;
 
-void VoxelWorld::generation_queue_add_to(const Ref<VoxelChunk> &chunk) {
-	ERR_FAIL_COND(!chunk.is_valid());
+	if (chunk.is_valid())
+		chunk->set_active_lists(chunk->get_active_lists() & ~ACTIVE_LIST_GENERATION_QUEUE);
 
-	set_process_internal(true);
+	int last = _generation_queue.size() - 1;
 
-	_generation_queue.push_back(chunk);
-}
-Ref<VoxelChunk> VoxelWorld::generation_queue_get_index(int index) {
-	ERR_FAIL_INDEX_V(index, _generation_queue.size(), NULL);
+	if (index != last) {
+		GenerationQueueEntry entry = _generation_queue[last];
+		_generation_queue.set(index, entry);
+	}
 
-	return _generation_queue.get(index);
-}
-void VoxelWorld::generation_queue_remove_index(int index) {
-	ERR_FAIL_INDEX(index, _generation_queue.size());
+	_generation_queue.resize(last);
 
-	_generation_queue.remove(index);
+	if (index < last) {
+		_generation_queue_sift_down(index);
+		_generation_queue_sift_up(index);
+	}
 }
-int VoxelWorld::generation_queue_get_size() const {
-	return _generation_queue.size();
+void VoxelWorld::_generation_queue_sift_up(int index) {
+	heap_sift_up(_generation_queue.ptrw(), index);
+}
+void VoxelWorld::_generation_queue_sift_down(int index) {
+	heap_sift_down(_generation_queue.ptrw(), _generation_queue.size(), index);
 }
 
 void VoxelWorld::generation_add_to(const Ref<VoxelChunk> &chunk) {
@@ -729,6 +2216,15 @@ uint8_t VoxelWorld::get_voxel_at_world_position(const Vector3 &world_position, c
 	if (chunk.is_valid())
 		return chunk->get_voxel(bx, by, bz, channel_index);
 
+	int value_index = _sparse_get(x, y, z);
+
+	if (value_index != -1) {
+		const Vector<uint8_t> &values = _sparse_values[value_index];
+
+		if (channel_index >= 0 && channel_index < values.size())
+			return values[channel_index];
+	}
+
 	return 0;
 }
 
@@ -762,7 +2258,7 @@ void VoxelWorld::set_voxel_at_world_position(const Vector3 &world_position, cons
 			chunk->set_voxel(data, get_chunk_size_x(), by, bz, channel_index);
 
 			if (rebuild)
-				chunk->build();
+				chunk_mark_dirty(chunk);
 		}
 
 		if (by == 0) {
@@ -770,7 +2266,7 @@ void VoxelWorld::set_voxel_at_world_position(const Vector3 &world_position, cons
 			chunk->set_voxel(data, bx, get_chunk_size_y(), bz, channel_index);
 
 			if (rebuild)
-				chunk->build();
+				chunk_mark_dirty(chunk);
 		}
 
 		if (bz == 0) {
@@ -778,7 +2274,7 @@ void VoxelWorld::set_voxel_at_world_position(const Vector3 &world_position, cons
 			chunk->set_voxel(data, bx, by, get_chunk_size_z(), channel_index);
 
 			if (rebuild)
-				chunk->build();
+				chunk_mark_dirty(chunk);
 		}
 	}
 
@@ -788,7 +2284,7 @@ void VoxelWorld::set_voxel_at_world_position(const Vector3 &world_position, cons
 			chunk->set_voxel(data, -1, by, bz, channel_index);
 
 			if (rebuild)
-				chunk->build();
+				chunk_mark_dirty(chunk);
 		}
 
 		if (by == get_chunk_size_y() - 1) {
@@ -796,7 +2292,7 @@ void VoxelWorld::set_voxel_at_world_position(const Vector3 &world_position, cons
 			chunk->set_voxel(data, bx, -1, bz, channel_index);
 
 			if (rebuild)
-				chunk->build();
+				chunk_mark_dirty(chunk);
 		}
 
 		if (bz == get_chunk_size_z() - 1) {
@@ -804,7 +2300,7 @@ void VoxelWorld::set_voxel_at_world_position(const Vector3 &world_position, cons
 			chunk->set_voxel(data, bx, by, -1, channel_index);
 
 			if (rebuild)
-				chunk->build();
+				chunk_mark_dirty(chunk);
 		}
 	}
 
@@ -812,7 +2308,447 @@ void VoxelWorld::set_voxel_at_world_position(const Vector3 &world_position, cons
 	chunk->set_voxel(data, bx, by, bz, channel_index);
 
 	if (rebuild)
-		chunk->build();
+		chunk_mark_dirty(chunk);
+}
+
+Array VoxelWorld::set_voxels_box(const AABB &world_box, const int data, const int channel_index, const bool rebuild) {
+	Vector3 from = world_box.position / get_voxel_scale();
+	Vector3 to = (world_box.position + world_box.size) / get_voxel_scale();
+
+	int min[3] = {
+		static_cast<int>(Math::ceil(from.x - 0.5)),
+		static_cast<int>(Math::ceil(from.y - 0.5)),
+		static_cast<int>(Math::ceil(from.z - 0.5))
+	};
+
+	int max[3] = {
+		static_cast<int>(Math::floor(to.x - 0.5)),
+		static_cast<int>(Math::floor(to.y - 0.5)),
+		static_cast<int>(Math::floor(to.z - 0.5))
+	};
+
+	return _set_voxels_region(min, max, false, Vector3(), 0, data, channel_index, rebuild);
+}
+
+Array VoxelWorld::set_voxels_sphere(const Vector3 &world_center, const float world_radius, const int data, const int channel_index, const bool rebuild) {
+	Vector3 center = world_center / get_voxel_scale();
+	float radius = world_radius / get_voxel_scale();
+
+	int min[3] = {
+		static_cast<int>(Math::ceil(center.x - radius - 0.5)),
+		static_cast<int>(Math::ceil(center.y - radius - 0.5)),
+		static_cast<int>(Math::ceil(center.z - radius - 0.5))
+	};
+
+	int max[3] = {
+		static_cast<int>(Math::floor(center.x + radius - 0.5)),
+		static_cast<int>(Math::floor(center.y + radius - 0.5)),
+		static_cast<int>(Math::floor(center.z + radius - 0.5))
+	};
+
+	return _set_voxels_region(min, max, true, center, radius * radius, data, channel_index, rebuild);
+}
+
+Array VoxelWorld::set_voxels_batch(const PoolVector3Array &world_positions, const PoolIntArray &data, const int channel_index, const bool rebuild) {
+	Array touched;
+
+	ERR_FAIL_COND_V_MSG(data.size() != world_positions.size() && data.size() != 1, touched, "Error, data needs one value, or one value per position!");
+
+	int size[3] = { _chunk_size_x, _chunk_size_y, _chunk_size_z };
+
+	HashMap<IntPos, Ref<VoxelChunk>, IntPosHasher> chunks;
+	IntPos last_pos;
+	Ref<VoxelChunk> last_chunk;
+
+#if !GODOT4
+	PoolVector3Array::Read pr = world_positions.read();
+	PoolIntArray::Read dr = data.read();
+
+	const Vector3 *positions = pr.ptr();
+	const int *values = dr.ptr();
+#else
+	const Vector3 *positions = world_positions.ptr();
+	const int64_t *values = data.ptr();
+#endif
+
+	for (int i = 0; i < world_positions.size(); ++i) {
+		Vector3 p = positions[i] / get_voxel_scale();
+		int value = data.size() == 1 ? values[0] : values[i];
+
+		ERR_CONTINUE_MSG(value < 0 || value > 65535, "Error, data needs to fit into 16 bits!");
+
+		//Note: floor is needed to handle negative numbers properly
+		int v[3] = {
+			static_cast<int>(Math::floor(p.x)),
+			static_cast<int>(Math::floor(p.y)),
+			static_cast<int>(Math::floor(p.z))
+		};
+
+		int c[3];
+		int l[3];
+
+		//The owner chunk, and the neighbours that have this voxel in their margins
+		int offsets[3][3];
+		int offset_counts[3];
+
+		for (int j = 0; j < 3; ++j) {
+			c[j] = floor_div(v[j], size[j]);
+			l[j] = v[j] - c[j] * size[j];
+
+			offset_counts[j] = 0;
+			offsets[j][offset_counts[j]++] = 0;
+
+			if (l[j] < _data_margin_end)
+				offsets[j][offset_counts[j]++] = -1;
+
+			if (l[j] >= size[j] - _data_margin_start)
+				offsets[j][offset_counts[j]++] = 1;
+		}
+
+		for (int ix = 0; ix < offset_counts[0]; ++ix) {
+			for (int iy = 0; iy < offset_counts[1]; ++iy) {
+				for (int iz = 0; iz < offset_counts[2]; ++iz) {
+					int ox = offsets[0][ix];
+					int oy = offsets[1][iy];
+					int oz = offsets[2][iz];
+
+					IntPos pos(c[0] + ox, c[1] + oy, c[2] + oz);
+
+					if (!last_chunk.is_valid() || !(pos == last_pos)) {
+						Ref<VoxelChunk> *cached = chunks.getptr(pos);
+
+						if (cached) {
+							last_chunk = *cached;
+						} else {
+							last_chunk = chunk_get_or_create(pos.x, pos.y, pos.z);
+
+							ERR_CONTINUE(!last_chunk.is_valid());
+
+							chunks.set(pos, last_chunk);
+							touched.push_back(last_chunk);
+						}
+
+						last_pos = pos;
+					}
+
+					//Also clears the high byte for 8 bit values
+					last_chunk->set_voxel16(value, l[0] - ox * size[0], l[1] - oy * size[1], l[2] - oz * size[2], channel_index);
+				}
+			}
+		}
+	}
+
+	if (rebuild) {
+		for (int i = 0; i < touched.size(); ++i) {
+			chunk_mark_dirty(touched[i]);
+		}
+	}
+
+	return touched;
+}
+
+Array VoxelWorld::_set_voxels_region(const int *min, const int *max, const bool sphere, const Vector3 &center, const float radius_squared, const int data, const int channel_index, const bool rebuild) {
+	Array touched;
+
+	ERR_FAIL_COND_V_MSG(data < 0 || data > 65535, touched, "Error, data needs to fit into 16 bits!");
+
+	if (min[0] > max[0] || min[1] > max[1] || min[2] > max[2])
+		return touched;
+
+	int size[3] = { _chunk_size_x, _chunk_size_y, _chunk_size_z };
+
+	//Chunks that only have the region in their margins need it too
+	int cmin[3];
+	int cmax[3];
+
+	for (int i = 0; i < 3; ++i) {
+		cmin[i] = floor_div(min[i] - _data_margin_end, size[i]);
+		cmax[i] = floor_div(max[i] + _data_margin_start, size[i]);
+	}
+
+	Vector<int> channels;
+	channels.push_back(channel_index);
+
+	Vector<uint8_t> buffer;
+	Vector<uint16_t> buffer16;
+
+	for (int cz = cmin[2]; cz <= cmax[2]; ++cz) {
+		for (int cx = cmin[0]; cx <= cmax[0]; ++cx) {
+			for (int cy = cmin[1]; cy <= cmax[1]; ++cy) {
+				int c[3] = { cx, cy, cz };
+				int lmin[3];
+				int lmax[3];
+
+				for (int i = 0; i < 3; ++i) {
+					lmin[i] = MAX(min[i] - c[i] * size[i], -_data_margin_start);
+					lmax[i] = MIN(max[i] - c[i] * size[i], size[i] - 1 + _data_margin_end);
+				}
+
+				if (lmin[0] > lmax[0] || lmin[1] > lmax[1] || lmin[2] > lmax[2])
+					continue;
+
+				//Voxel center of the region's first voxel
+				Vector3 offset(cx * size[0] + lmin[0] + 0.5, cy * size[1] + lmin[1] + 0.5, cz * size[2] + lmin[2] + 0.5);
+
+				if (sphere) {
+					//The region's voxel center that's closest to the sphere's center, corner chunks often don't have any inside
+					Vector3 end(cx * size[0] + lmax[0] + 0.5, cy * size[1] + lmax[1] + 0.5, cz * size[2] + lmax[2] + 0.5);
+					Vector3 closest(CLAMP(center.x, offset.x, end.x), CLAMP(center.y, offset.y, end.y), CLAMP(center.z, offset.z, end.z));
+
+					if (closest.distance_squared_to(center) > radius_squared)
+						continue;
+				}
+
+				AABB region(Vector3(lmin[0], lmin[1], lmin[2]), Vector3(lmax[0] - lmin[0] + 1, lmax[1] - lmin[1] + 1, lmax[2] - lmin[2] + 1));
+
+				Ref<VoxelChunk> chunk = chunk_get_or_create(cx, cy, cz);
+
+				ERR_CONTINUE(!chunk.is_valid());
+
+				bool success;
+
+				//8 bit writes clear the high bytes, so 16 bit channels always need the 16 bit path
+				if (data > 255 || chunk->channel_get_width(channel_index) == 16)
+					success = region_fill<uint16_t>(chunk, buffer16, region, channels, sphere, offset, center, radius_squared, data);
+				else
+					success = region_fill<uint8_t>(chunk, buffer, region, channels, sphere, offset, center, radius_squared, data);
+
+				if (!success)
+					continue;
+
+				touched.push_back(chunk);
+
+				if (rebuild)
+					chunk_mark_dirty(chunk);
+			}
+		}
+	}
+
+	return touched;
+}
+
+Dictionary VoxelWorld::raycast(const Vector3 &from, const Vector3 &direction, const float max_distance, const int channel_index) {
+	Dictionary result;
+
+	ERR_FAIL_COND_V(direction == Vector3(), result);
+
+	//Amanatides - Woo traversal in voxel space
+	Vector3 origin = from / get_voxel_scale();
+	Vector3 dir = direction.normalized();
+	float max_t = max_distance / get_voxel_scale();
+
+	ERR_FAIL_COND_V_MSG(Math::is_nan(max_t) || max_t < 0, result, "Error, max_distance needs to be positive!");
+
+	//INF, or huge distances would walk the grid for a very long time, missing chunks included
+	max_t = MIN(max_t, static_cast<float>(1 << 16));
+
+	//Each step crosses one cell boundary, a ray can't cross more than this many before reaching max_t.
+	//It also stops the loop if t stops increasing because of float precision far from the origin.
+	int max_steps = static_cast<int>(Math::ceil(max_t * (Math::abs(dir.x) + Math::abs(dir.y) + Math::abs(dir.z)))) + 3;
+
+	int v[3] = {
+		static_cast<int>(Math::floor(origin.x)),
+		static_cast<int>(Math::floor(origin.y)),
+		static_cast<int>(Math::floor(origin.z))
+	};
+
+	int step[3];
+	float t_max[3];
+	float t_delta[3];
+
+	for (int i = 0; i < 3; ++i) {
+		if (dir[i] > 0) {
+			step[i] = 1;
+			t_max[i] = (v[i] + 1 - origin[i]) / dir[i];
+			t_delta[i] = 1.0 / dir[i];
+		} else if (dir[i] < 0) {
+			step[i] = -1;
+			t_max[i] = (v[i] - origin[i]) / dir[i];
+			t_delta[i] = -1.0 / dir[i];
+		} else {
+			step[i] = 0;
+			t_max[i] = Math_INF;
+			t_delta[i] = Math_INF;
+		}
+	}
+
+	VoxelQueryCache cache;
+	Vector3 normal;
+	float t = 0;
+	uint16_t value = _query_voxel(v[0], v[1], v[2], channel_index, cache);
+
+	for (int steps = 0; value == 0; ++steps) {
+		if (steps >= max_steps)
+			return result;
+
+		int axis = 0;
+
+		if (t_max[1] < t_max[axis])
+			axis = 1;
+
+		if (t_max[2] < t_max[axis])
+			axis = 2;
+
+		t = t_max[axis];
+
+		if (t > max_t)
+			return result;
+
+		v[axis] += step[axis];
+		t_max[axis] += t_delta[axis];
+
+		normal = Vector3();
+		normal[axis] = -step[axis];
+
+		value = _query_voxel(v[0], v[1], v[2], channel_index, cache);
+	}
+
+	result["position"] = (origin + dir * t) * get_voxel_scale();
+	result["normal"] = normal;
+	result["voxel"] = Vector3(v[0], v[1], v[2]);
+	result["value"] = value;
+	result["distance"] = t * get_voxel_scale();
+	result["chunk"] = cache.chunk;
+
+	return result;
+}
+
+Dictionary VoxelWorld::sweep_aabb(const AABB &world_box, const Vector3 &motion, const int channel_index) {
+	Dictionary result;
+
+	Vector3 box_min = world_box.position / get_voxel_scale();
+	Vector3 box_max = (world_box.position + world_box.size) / get_voxel_scale();
+	Vector3 m = motion / get_voxel_scale();
+
+	//Broadphase, every voxel the box can touch on it's way
+	Vector3 area_min = box_min + Vector3(MIN(m.x, 0), MIN(m.y, 0), MIN(m.z, 0));
+	Vector3 area_max = box_max + Vector3(MAX(m.x, 0), MAX(m.y, 0), MAX(m.z, 0));
+
+	int min[3];
+	int max[3];
+
+	for (int i = 0; i < 3; ++i) {
+		min[i] = static_cast<int>(Math::floor(area_min[i]));
+		max[i] = static_cast<int>(Math::ceil(area_max[i])) - 1;
+	}
+
+	int64_t volume = int64_t(max[0] - min[0] + 1) * (max[1] - min[1] + 1) * (max[2] - min[2] + 1);
+
+	ERR_FAIL_COND_V_MSG(volume > 1 << 20, result, "Error, the swept area is too big!");
+
+	VoxelQueryCache cache;
+	float best_t = Math_INF;
+	int best_axis = -1;
+	int best_voxel[3] = { 0, 0, 0 };
+	uint16_t best_value = 0;
+
+	for (int z = min[2]; z <= max[2]; ++z) {
+		for (int x = min[0]; x <= max[0]; ++x) {
+			for (int y = min[1]; y <= max[1]; ++y) {
+				uint16_t value = _query_voxel(x, y, z, channel_index, cache);
+
+				if (value == 0)
+					continue;
+
+				int v[3] = { x, y, z };
+				float t_entry = -Math_INF;
+				float t_exit = Math_INF;
+				int entry_axis = -1;
+				bool miss = false;
+
+				for (int i = 0; i < 3; ++i) {
+					float enter;
+					float exit;
+
+					if (m[i] > 0) {
+						enter = (v[i] - box_max[i]) / m[i];
+						exit = (v[i] + 1 - box_min[i]) / m[i];
+					} else if (m[i] < 0) {
+						enter = (v[i] + 1 - box_min[i]) / m[i];
+						exit = (v[i] - box_max[i]) / m[i];
+					} else {
+						if (box_max[i] <= v[i] || box_min[i] >= v[i] + 1) {
+							miss = true;
+							break;
+						}
+
+						continue;
+					}
+
+					if (enter > t_entry) {
+						t_entry = enter;
+						entry_axis = i;
+					}
+
+					if (exit < t_exit)
+						t_exit = exit;
+				}
+
+				//Voxels the box already overlaps are ignored, so it can move out of them
+				if (miss || entry_axis == -1 || t_entry < 0 || t_entry > 1 || t_entry >= t_exit)
+					continue;
+
+				if (t_entry < best_t) {
+					best_t = t_entry;
+					best_axis = entry_axis;
+					best_voxel[0] = x;
+					best_voxel[1] = y;
+					best_voxel[2] = z;
+					best_value = value;
+				}
+			}
+		}
+	}
+
+	if (best_axis == -1)
+		return result;
+
+	Vector3 normal;
+	normal[best_axis] = m[best_axis] > 0 ? -1 : 1;
+
+	result["fraction"] = best_t;
+	result["motion"] = motion * best_t;
+	result["normal"] = normal;
+	result["voxel"] = Vector3(best_voxel[0], best_voxel[1], best_voxel[2]);
+	result["value"] = best_value;
+
+	return result;
+}
+
+uint16_t VoxelWorld::_query_voxel(const int x, const int y, const int z, const int channel_index, VoxelQueryCache &cache) {
+	IntPos pos(floor_div(x, _chunk_size_x), floor_div(y, _chunk_size_y), floor_div(z, _chunk_size_z));
+
+	if (!cache.valid || !(pos == cache.position)) {
+		cache.valid = true;
+		cache.position = pos;
+		cache.chunk = chunk_get(pos.x, pos.y, pos.z);
+		cache.uniform_value = 0;
+
+		if (cache.chunk.is_valid()) {
+			if (channel_index < 0 || channel_index >= cache.chunk->channel_get_count()) {
+				cache.chunk.unref();
+			} else {
+				//Also makes evicted channels resident
+				uint16_t first = cache.chunk->get_voxel16(0, 0, 0, channel_index);
+
+				cache.uniform_value = cache.chunk->channel_is_uniform(channel_index) ? first : -1;
+			}
+		} else {
+			int value_index = _sparse_get(pos.x, pos.y, pos.z);
+
+			if (value_index != -1) {
+				const Vector<uint8_t> &values = _sparse_values[value_index];
+
+				if (channel_index >= 0 && channel_index < values.size())
+					cache.uniform_value = values[channel_index];
+			}
+		}
+	}
+
+	if (cache.uniform_value >= 0)
+		return cache.uniform_value;
+
+	return cache.chunk->get_voxel16_unchecked(x - pos.x * _chunk_size_x, y - pos.y * _chunk_size_y, z - pos.z * _chunk_size_z, channel_index);
 }
 
 Ref<VoxelChunk> VoxelWorld::get_chunk_at_world_position(const Vector3 &world_position) {
@@ -855,26 +2791,69 @@ VoxelWorld::VoxelWorld() {
 	_current_seed = 0;
 	_data_margin_start = 0;
 	_data_margin_end = 0;
+	_data_layout = VoxelChunk::DATA_LAYOUT_LINEAR;
+
+	_sparse_storage = false;
+	_sparse_chunk_count = 0;
+	_sparse_run_count = 0;
+
+	_memory_budget = 0;
+	_memory_budget_stalled = false;
+	_compression_dictionary_hash = 0;
 
 	set_use_threads(true);
 	set_max_concurrent_generations(3);
 
 	_voxel_scale = 1;
 	_chunk_spawn_range = 4;
+	_chunk_spawn_range_y = 2;
+	_chunk_despawn_margin = 1;
+
+	_streaming = false;
+	_streaming_shape = STREAMING_SHAPE_SPHERE;
+	_streaming_offsets_dirty = true;
+	_streaming_has_center = false;
+	_streaming_walk_shell = false;
+	_streaming_cursor = 0;
 
 	_player = NULL;
 	_max_frame_chunk_build_steps = 0;
+
+#if !THREAD_POOL_PRESENT
+	_job_frame_budget = 4;
+	_sliced_jobs_sequence = 0;
+#endif
 	_num_frame_chunk_build_steps = 0;
+
+	_dirty_flush_interval = 0;
+	_dirty_flush_timer = 0;
+
+	_generation_queue_sequence = 0;
+	_generation_has_view = false;
+
+	_buffer_pool.instance();
 }
 
 VoxelWorld ::~VoxelWorld() {
 	_chunks.clear();
+
+	//Chunks can outlive the world
+	for (int i = 0; i < _chunks_vector.size(); ++i) {
+		_chunk_detach(_chunks_vector[i]);
+	}
+
 	_chunks_vector.clear();
+	_active_process.clear();
+	_active_physics_process.clear();
+	_active_generating.clear();
+	_dirty_chunks.clear();
+	sparse_clear();
 	_world_areas.clear();
 	_voxel_structures.clear();
 
 	_library.unref();
 	_level_generator.unref();
+	_buffer_pool.unref();
 
 	_player = NULL;
 
@@ -930,24 +2909,60 @@ void VoxelWorld::_notification(int p_what) {
 		case NOTIFICATION_INTERNAL_PROCESS: {
 			_num_frame_chunk_build_steps = 0;
 
-			for (int i = 0; i < _chunks_vector.size(); ++i) {
-				Ref<VoxelChunk> chunk = _chunks_vector[i];
-
-				ERR_CONTINUE(!chunk.is_valid());
+			for (int i = 0; i < _active_process.size(); ++i) {
+				Ref<VoxelChunk> chunk = _active_process[i];
 
-				if (chunk->get_process()) {
-					chunk->process(get_process_delta_time());
+				if (!chunk->get_process()) {
+					_active_list_remove(_active_process, i, ACTIVE_LIST_PROCESS);
+					--i;
+					continue;
 				}
 
-				if (chunk->get_is_generating()) {
-					chunk->generation_process(get_process_delta_time());
+				chunk->process(get_process_delta_time());
+			}
+
+			for (int i = 0; i < _active_generating.size(); ++i) {
+				Ref<VoxelChunk> chunk = _active_generating[i];
+
+				if (!chunk->get_is_generating()) {
+					chunk->finalize_build_channels();
+
+					_active_list_remove(_active_generating, i, ACTIVE_LIST_GENERATING);
+					--i;
+					continue;
 				}
+
+				chunk->generation_process(get_process_delta_time());
 			}
 
+			if (_streaming)
+				streaming_update();
+
+			if (_dirty_chunks.size() > 0) {
+				_dirty_flush_timer += get_process_delta_time();
+
+				if (_dirty_flush_timer >= _dirty_flush_interval)
+					dirty_flush();
+			}
+
+			if (_generation_update_view())
+				_generation_queue_rebuild();
+
+#if !THREAD_POOL_PRESENT
+			if (_sliced_jobs.size() > 0)
+				_sliced_jobs_process();
+#endif
+
+			if (_region_store.is_valid() && _region_loading.size() > 0)
+				_region_store_poll();
+
+			if (_memory_budget > 0 && !_memory_budget_stalled)
+				memory_budget_enforce();
+
 #if VERSION_MAJOR > 3
-			if (_is_priority_generation && _generation_queue.is_empty() && _generating.is_empty()) {
+			if (_is_priority_generation && _generation_queue.is_empty() && _generating.is_empty() && _region_loading.is_empty()) {
 #else
-			if (_is_priority_generation && _generation_queue.empty() && _generating.empty()) {
+			if (_is_priority_generation && _generation_queue.empty() && _generating.empty() && _region_loading.empty()) {
 #endif
 				_is_priority_generation = false;
 
@@ -968,17 +2983,40 @@ void VoxelWorld::_notification(int p_what) {
 				}
 			}
 
-			if (_generating.size() >= _max_concurrent_generations)
+			if (_generating.size() + _region_loading.size() >= _max_concurrent_generations)
 				return;
 
 			if (_generation_queue.size() == 0)
 				return;
 
-			while (_generating.size() < _max_concurrent_generations && _generation_queue.size() != 0) {
-				Ref<VoxelChunk> chunk = _generation_queue.get(0);
-				_generation_queue.remove(0);
+			while (_generating.size() + _region_loading.size() < _max_concurrent_generations && _generation_queue.size() != 0) {
+				Ref<VoxelChunk> chunk = _generation_queue_pop();
+
+				//Cancelled
+				if (!chunk.is_valid() || chunk->get_voxel_world() != this)
+					continue;
+
+				//Stored chunks are loaded instead, they only get generated if the store doesn't have them
+				if (_region_store.is_valid() && _region_store->is_open()) {
+					IntPos pos(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z());
+					RegionLoad *load = _region_loading.getptr(pos);
+
+					if (!load) {
+						_region_loading.set(pos, RegionLoad());
+						load = _region_loading.getptr(pos);
+					}
+
+					//A chunk that got removed while it was loading
+					if (load->chunk.is_valid() && load->chunk != chunk)
+						load->chunk->set_active_lists(load->chunk->get_active_lists() & ~ACTIVE_LIST_REGION_LOADING);
+
+					load->chunk = chunk;
+					++load->requests;
 
-				ERR_FAIL_COND(!chunk.is_valid());
+					chunk->set_active_lists(chunk->get_active_lists() | ACTIVE_LIST_REGION_LOADING);
+					_region_store->load_request(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z());
+					continue;
+				}
 
 				_generating.push_back(chunk);
 
@@ -986,18 +3024,30 @@ void VoxelWorld::_notification(int p_what) {
 			}
 		} break;
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
-			for (int i = 0; i < _chunks_vector.size(); ++i) {
-				Ref<VoxelChunk> chunk = _chunks_vector[i];
+			for (int i = 0; i < _active_physics_process.size(); ++i) {
+				Ref<VoxelChunk> chunk = _active_physics_process[i];
 
-				ERR_CONTINUE(!chunk.is_valid());
-
-				if (chunk->get_process()) {
-					chunk->physics_process(get_physics_process_delta_time());
+				if (!chunk->get_physics_process()) {
+					_active_list_remove(_active_physics_process, i, ACTIVE_LIST_PHYSICS_PROCESS);
+					--i;
+					continue;
 				}
 
-				if (chunk->get_is_generating()) {
-					chunk->generation_physics_process(get_physics_process_delta_time());
+				chunk->physics_process(get_physics_process_delta_time());
+			}
+
+			for (int i = 0; i < _active_generating.size(); ++i) {
+				Ref<VoxelChunk> chunk = _active_generating[i];
+
+				if (!chunk->get_is_generating()) {
+					chunk->finalize_build_channels();
+
+					_active_list_remove(_active_generating, i, ACTIVE_LIST_GENERATING);
+					--i;
+					continue;
 				}
+
+				chunk->generation_physics_process(get_physics_process_delta_time());
 			}
 
 		} break;
@@ -1013,6 +3063,9 @@ void VoxelWorld::_notification(int p_what) {
 				}
 			}
 
+#if !THREAD_POOL_PRESENT
+			_sliced_jobs_clear();
+#endif
 		} break;
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 			for (int i = 0; i < _chunks_vector.size(); ++i) {
@@ -1054,6 +3107,10 @@ void VoxelWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_data_margin_end", "value"), &VoxelWorld::set_data_margin_end);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "data_margin_end"), "set_data_margin_end", "get_data_margin_end");
 
+	ClassDB::bind_method(D_METHOD("get_data_layout"), &VoxelWorld::get_data_layout);
+	ClassDB::bind_method(D_METHOD("set_data_layout", "value"), &VoxelWorld::set_data_layout);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "data_layout", PROPERTY_HINT_ENUM, VoxelChunk::BINDING_STRING_DATA_LAYOUT), "set_data_layout", "get_data_layout");
+
 	ClassDB::bind_method(D_METHOD("get_current_seed"), &VoxelWorld::get_current_seed);
 	ClassDB::bind_method(D_METHOD("set_current_seed", "value"), &VoxelWorld::set_current_seed);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "current_seed"), "set_current_seed", "get_current_seed");
@@ -1070,6 +3127,19 @@ void VoxelWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_max_frame_chunk_build_steps", "value"), &VoxelWorld::set_max_frame_chunk_build_steps);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_frame_chunk_build_steps"), "set_max_frame_chunk_build_steps", "get_max_frame_chunk_build_steps");
 
+#if !THREAD_POOL_PRESENT
+	ClassDB::bind_method(D_METHOD("get_job_frame_budget"), &VoxelWorld::get_job_frame_budget);
+	ClassDB::bind_method(D_METHOD("set_job_frame_budget", "value"), &VoxelWorld::set_job_frame_budget);
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "job_frame_budget"), "set_job_frame_budget", "get_job_frame_budget");
+
+	ClassDB::bind_method(D_METHOD("job_sliced_add", "job"), &VoxelWorld::job_sliced_add);
+	ClassDB::bind_method(D_METHOD("job_sliced_get_count"), &VoxelWorld::job_sliced_get_count);
+#endif
+
+	ClassDB::bind_method(D_METHOD("get_dirty_flush_interval"), &VoxelWorld::get_dirty_flush_interval);
+	ClassDB::bind_method(D_METHOD("set_dirty_flush_interval", "value"), &VoxelWorld::set_dirty_flush_interval);
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "dirty_flush_interval"), "set_dirty_flush_interval", "get_dirty_flush_interval");
+
 	ClassDB::bind_method(D_METHOD("get_library"), &VoxelWorld::get_library);
 	ClassDB::bind_method(D_METHOD("set_library", "library"), &VoxelWorld::set_library);
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "library", PROPERTY_HINT_RESOURCE_TYPE, "VoxelmanLibrary"), "set_library", "get_library");
@@ -1078,6 +3148,9 @@ void VoxelWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_level_generator", "level_generator"), &VoxelWorld::set_level_generator);
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "level_generator", PROPERTY_HINT_RESOURCE_TYPE, "VoxelmanLevelGenerator"), "set_level_generator", "get_level_generator");
 
+	ClassDB::bind_method(D_METHOD("get_buffer_pool"), &VoxelWorld::get_buffer_pool);
+	ClassDB::bind_method(D_METHOD("set_buffer_pool", "pool"), &VoxelWorld::set_buffer_pool);
+
 	ClassDB::bind_method(D_METHOD("get_voxel_scale"), &VoxelWorld::get_voxel_scale);
 	ClassDB::bind_method(D_METHOD("set_voxel_scale", "value"), &VoxelWorld::set_voxel_scale);
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "voxel_scale"), "set_voxel_scale", "get_voxel_scale");
@@ -1086,6 +3159,52 @@ void VoxelWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_chunk_spawn_range", "value"), &VoxelWorld::set_chunk_spawn_range);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "chunk_spawn_range"), "set_chunk_spawn_range", "get_chunk_spawn_range");
 
+	ClassDB::bind_method(D_METHOD("get_chunk_spawn_range_y"), &VoxelWorld::get_chunk_spawn_range_y);
+	ClassDB::bind_method(D_METHOD("set_chunk_spawn_range_y", "value"), &VoxelWorld::set_chunk_spawn_range_y);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "chunk_spawn_range_y"), "set_chunk_spawn_range_y", "get_chunk_spawn_range_y");
+
+	ClassDB::bind_method(D_METHOD("get_chunk_despawn_margin"), &VoxelWorld::get_chunk_despawn_margin);
+	ClassDB::bind_method(D_METHOD("set_chunk_despawn_margin", "value"), &VoxelWorld::set_chunk_despawn_margin);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "chunk_despawn_margin"), "set_chunk_despawn_margin", "get_chunk_despawn_margin");
+
+	ClassDB::bind_method(D_METHOD("get_streaming"), &VoxelWorld::get_streaming);
+	ClassDB::bind_method(D_METHOD("set_streaming", "value"), &VoxelWorld::set_streaming);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "streaming"), "set_streaming", "get_streaming");
+
+	ClassDB::bind_method(D_METHOD("get_streaming_shape"), &VoxelWorld::get_streaming_shape);
+	ClassDB::bind_method(D_METHOD("set_streaming_shape", "value"), &VoxelWorld::set_streaming_shape);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "streaming_shape", PROPERTY_HINT_ENUM, BINDING_STRING_STREAMING_SHAPE), "set_streaming_shape", "get_streaming_shape");
+
+	ClassDB::bind_method(D_METHOD("streaming_update"), &VoxelWorld::streaming_update);
+	ClassDB::bind_method(D_METHOD("streaming_reset"), &VoxelWorld::streaming_reset);
+
+	ClassDB::bind_method(D_METHOD("get_sparse_storage"), &VoxelWorld::get_sparse_storage);
+	ClassDB::bind_method(D_METHOD("set_sparse_storage", "value"), &VoxelWorld::set_sparse_storage);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "sparse_storage"), "set_sparse_storage", "get_sparse_storage");
+
+	ClassDB::bind_method(D_METHOD("get_memory_budget"), &VoxelWorld::get_memory_budget);
+	ClassDB::bind_method(D_METHOD("set_memory_budget", "value"), &VoxelWorld::set_memory_budget);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "memory_budget"), "set_memory_budget", "get_memory_budget");
+
+	ClassDB::bind_method(D_METHOD("get_region_store"), &VoxelWorld::get_region_store);
+	ClassDB::bind_method(D_METHOD("set_region_store", "value"), &VoxelWorld::set_region_store);
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "region_store", PROPERTY_HINT_RESOURCE_TYPE, "VoxelRegionStore"), "set_region_store", "get_region_store");
+
+	ClassDB::bind_method(D_METHOD("get_world_pack"), &VoxelWorld::get_world_pack);
+	ClassDB::bind_method(D_METHOD("set_world_pack", "value"), &VoxelWorld::set_world_pack);
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "world_pack", PROPERTY_HINT_RESOURCE_TYPE, "VoxelWorldPack"), "set_world_pack", "get_world_pack");
+
+	ClassDB::bind_method(D_METHOD("get_compression_dictionary"), &VoxelWorld::get_compression_dictionary);
+	ClassDB::bind_method(D_METHOD("set_compression_dictionary", "data"), &VoxelWorld::set_compression_dictionary);
+	ADD_PROPERTY(PropertyInfo(Variant::POOL_BYTE_ARRAY, "compression_dictionary"), "set_compression_dictionary", "get_compression_dictionary");
+	ClassDB::bind_method(D_METHOD("get_compression_dictionary_hash"), &VoxelWorld::get_compression_dictionary_hash);
+
+	ClassDB::bind_method(D_METHOD("get_compression_dictionary_history"), &VoxelWorld::get_compression_dictionary_history);
+	ClassDB::bind_method(D_METHOD("set_compression_dictionary_history", "data"), &VoxelWorld::set_compression_dictionary_history);
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "compression_dictionary_history"), "set_compression_dictionary_history", "get_compression_dictionary_history");
+
+	ClassDB::bind_method(D_METHOD("region_store_save"), &VoxelWorld::region_store_save);
+
 	ClassDB::bind_method(D_METHOD("get_player_path"), &VoxelWorld::get_player_path);
 	ClassDB::bind_method(D_METHOD("set_player_path", "value"), &VoxelWorld::set_player_path);
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "player_path"), "set_player_path", "get_player_path");
@@ -1117,6 +3236,7 @@ void VoxelWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("chunk_add", "chunk", "x", "y", "z"), &VoxelWorld::chunk_add);
 	ClassDB::bind_method(D_METHOD("chunk_has", "x", "y", "z"), &VoxelWorld::chunk_has);
 	ClassDB::bind_method(D_METHOD("chunk_get", "x", "y", "z"), &VoxelWorld::chunk_get);
+	ClassDB::bind_method(D_METHOD("chunk_get_threaded", "x", "y", "z"), &VoxelWorld::chunk_get_threaded);
 	ClassDB::bind_method(D_METHOD("chunk_remove", "x", "y", "z"), &VoxelWorld::chunk_remove);
 	ClassDB::bind_method(D_METHOD("chunk_remove_index", "index"), &VoxelWorld::chunk_remove_index);
 
@@ -1133,6 +3253,7 @@ void VoxelWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("generation_queue_get_index", "index"), &VoxelWorld::generation_queue_get_index);
 	ClassDB::bind_method(D_METHOD("generation_queue_remove_index", "index"), &VoxelWorld::generation_queue_remove_index);
 	ClassDB::bind_method(D_METHOD("generation_queue_get_size"), &VoxelWorld::generation_queue_get_size);
+	ClassDB::bind_method(D_METHOD("generation_queue_update_priorities"), &VoxelWorld::generation_queue_update_priorities);
 
 	ClassDB::bind_method(D_METHOD("generation_add_to", "chunk"), &VoxelWorld::generation_add_to);
 	ClassDB::bind_method(D_METHOD("generation_get_index", "index"), &VoxelWorld::generation_get_index);
@@ -1153,6 +3274,22 @@ void VoxelWorld::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("_create_chunk", "x", "y", "z", "chunk"), &VoxelWorld::_create_chunk);
 	ClassDB::bind_method(D_METHOD("_generate_chunk", "chunk"), &VoxelWorld::_generate_chunk);
 
+	ClassDB::bind_method(D_METHOD("chunk_is_sparse", "x", "y", "z"), &VoxelWorld::chunk_is_sparse);
+	ClassDB::bind_method(D_METHOD("sparse_get_chunk_count"), &VoxelWorld::sparse_get_chunk_count);
+	ClassDB::bind_method(D_METHOD("sparse_get_run_count"), &VoxelWorld::sparse_get_run_count);
+	ClassDB::bind_method(D_METHOD("sparse_get_memory_usage"), &VoxelWorld::sparse_get_memory_usage);
+	ClassDB::bind_method(D_METHOD("sparse_clear"), &VoxelWorld::sparse_clear);
+	ClassDB::bind_method(D_METHOD("sparse_get_positions"), &VoxelWorld::sparse_get_positions);
+	ClassDB::bind_method(D_METHOD("sparse_get_values", "x", "y", "z"), &VoxelWorld::sparse_get_values);
+
+	ClassDB::bind_method(D_METHOD("get_memory_usage"), &VoxelWorld::get_memory_usage);
+	ClassDB::bind_method(D_METHOD("memory_budget_enforce"), &VoxelWorld::memory_budget_enforce);
+	ClassDB::bind_method(D_METHOD("compression_dictionary_train", "max_size"), &VoxelWorld::compression_dictionary_train, DEFVAL(65536));
+
+	ClassDB::bind_method(D_METHOD("chunk_mark_dirty", "chunk"), &VoxelWorld::chunk_mark_dirty);
+	ClassDB::bind_method(D_METHOD("dirty_get_count"), &VoxelWorld::dirty_get_count);
+	ClassDB::bind_method(D_METHOD("dirty_flush"), &VoxelWorld::dirty_flush);
+
 	ClassDB::bind_method(D_METHOD("can_chunk_do_build_step"), &VoxelWorld::can_chunk_do_build_step);
 	ClassDB::bind_method(D_METHOD("is_position_walkable", "position"), &VoxelWorld::is_position_walkable);
 	ClassDB::bind_method(D_METHOD("on_chunk_mesh_generation_finished", "chunk"), &VoxelWorld::on_chunk_mesh_generation_finished);
@@ -1173,6 +3310,13 @@ void VoxelWorld::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_voxel_at_world_position", "world_position", "channel_index"), &VoxelWorld::get_voxel_at_world_position);
 	ClassDB::bind_method(D_METHOD("set_voxel_at_world_position", "world_position", "data", "channel_index", "rebuild"), &VoxelWorld::set_voxel_at_world_position, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("set_voxels_box", "world_box", "data", "channel_index", "rebuild"), &VoxelWorld::set_voxels_box, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("set_voxels_sphere", "world_center", "world_radius", "data", "channel_index", "rebuild"), &VoxelWorld::set_voxels_sphere, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("set_voxels_batch", "world_positions", "data", "channel_index", "rebuild"), &VoxelWorld::set_voxels_batch, DEFVAL(true));
+
+	ClassDB::bind_method(D_METHOD("raycast", "from", "direction", "max_distance", "channel_index"), &VoxelWorld::raycast);
+	ClassDB::bind_method(D_METHOD("sweep_aabb", "world_box", "motion", "channel_index"), &VoxelWorld::sweep_aabb);
+
 	ClassDB::bind_method(D_METHOD("get_chunk_at_world_position", "world_position"), &VoxelWorld::get_chunk_at_world_position);
 	ClassDB::bind_method(D_METHOD("get_or_create_chunk_at_world_position", "world_position"), &VoxelWorld::get_or_create_chunk_at_world_position);
 
@@ -1194,4 +3338,7 @@ void VoxelWorld::_bind_methods() {
 	BIND_ENUM_CONSTANT(CHANNEL_TYPE_INFO_TYPE);
 	BIND_ENUM_CONSTANT(CHANNEL_TYPE_INFO_ISOLEVEL);
 	BIND_ENUM_CONSTANT(CHANNEL_TYPE_INFO_LIQUID_FLOW);
+
+	BIND_ENUM_CONSTANT(STREAMING_SHAPE_SPHERE);
+	BIND_ENUM_CONSTANT(STREAMING_SHAPE_CYLINDER);
 }
@@ -38,9 +38,14 @@ SOFTWARE.
 #include navigation_h
 
 #include "../areas/world_area.h"
+#include "voxel_buffer_pool.h"
+#include "voxel_chunk_map.h"
+#include "voxel_region_store.h"
+#include "voxel_world_pack.h"
 #include "../level_generator/voxelman_level_generator.h"
 #include "../library/voxelman_library.h"
 
+#include "core/os/mutex.h"
 #include "core/os/os.h"
 
 #if PROPS_PRESENT
@@ -49,6 +54,7 @@ SOFTWARE.
 
 class VoxelStructure;
 class VoxelChunk;
+class VoxelJob;
 class PropData;
 
 class VoxelWorld : public Navigation {
@@ -61,7 +67,22 @@ public:
 		CHANNEL_TYPE_INFO_LIQUID_FLOW,
 	};
 
+	enum StreamingShape {
+		STREAMING_SHAPE_SPHERE = 0,
+		STREAMING_SHAPE_CYLINDER,
+	};
+
+	enum ActiveList {
+		ACTIVE_LIST_PROCESS = 1 << 0,
+		ACTIVE_LIST_PHYSICS_PROCESS = 1 << 1,
+		ACTIVE_LIST_GENERATING = 1 << 2,
+		ACTIVE_LIST_DIRTY = 1 << 3,
+		ACTIVE_LIST_GENERATION_QUEUE = 1 << 4,
+		ACTIVE_LIST_REGION_LOADING = 1 << 5,
+	};
+
 	static const String BINDING_STRING_CHANNEL_TYPE_INFO;
+	static const String BINDING_STRING_STREAMING_SHAPE;
 
 public:
 	bool get_editable() const;
@@ -82,6 +103,9 @@ public:
 	int get_data_margin_end() const;
 	void set_data_margin_end(const int value);
 
+	int get_data_layout() const;
+	void set_data_layout(const int value);
+
 	int get_current_seed() const;
 	void set_current_seed(const int value);
 
@@ -94,18 +118,72 @@ public:
 	int get_max_frame_chunk_build_steps() const;
 	void set_max_frame_chunk_build_steps(const int value);
 
+#if !THREAD_POOL_PRESENT
+	//In milliseconds, how much of a frame jobs executed on the main thread can use. 0 means they run until they finish.
+	float get_job_frame_budget() const;
+	void set_job_frame_budget(const float value);
+
+	//Jobs are resumed every frame, the ones closest to the player first
+	void job_sliced_add(const Ref<VoxelJob> &job);
+	int job_sliced_get_count() const;
+#endif
+
+	float get_dirty_flush_interval() const;
+	void set_dirty_flush_interval(const float value);
+
 	Ref<VoxelmanLibrary> get_library();
 	void set_library(const Ref<VoxelmanLibrary> &library);
 
 	Ref<VoxelmanLevelGenerator> get_level_generator() const;
 	void set_level_generator(const Ref<VoxelmanLevelGenerator> &level_generator);
 
+	Ref<VoxelBufferPool> get_buffer_pool() const;
+	void set_buffer_pool(const Ref<VoxelBufferPool> &pool);
+
 	float get_voxel_scale() const;
 	void set_voxel_scale(const float value);
 
 	int get_chunk_spawn_range() const;
 	void set_chunk_spawn_range(const int value);
 
+	int get_chunk_spawn_range_y() const;
+	void set_chunk_spawn_range_y(const int value);
+
+	int get_chunk_despawn_margin() const;
+	void set_chunk_despawn_margin(const int value);
+
+	bool get_streaming() const;
+	void set_streaming(const bool value);
+
+	int get_streaming_shape() const;
+	void set_streaming_shape(const int value);
+
+	bool get_sparse_storage() const;
+	void set_sparse_storage(const bool value);
+
+	int64_t get_memory_budget() const;
+	void set_memory_budget(const int64_t value);
+
+	Ref<VoxelRegionStore> get_region_store() const;
+	void set_region_store(const Ref<VoxelRegionStore> &store);
+
+	//Chunks in the pack are mapped from it instead of being generated
+	Ref<VoxelWorldPack> get_world_pack() const;
+	void set_world_pack(const Ref<VoxelWorldPack> &pack);
+
+	//Used by VoxelChunk::data_get_compressed(), and the region store. Data compressed with it can only be read with the same dictionary,
+	//so replaced dictionaries are kept in compression_dictionary_history. Thread safe.
+	PoolByteArray get_compression_dictionary() const;
+	void set_compression_dictionary(const PoolByteArray &data);
+	uint64_t get_compression_dictionary_hash() const;
+
+	Array get_compression_dictionary_history() const;
+	void set_compression_dictionary_history(const Array &data);
+
+	//Looks up the current, or an older dictionary
+	bool compression_dictionary_find(const uint64_t hash, PoolByteArray &r_data) const;
+	static uint64_t compression_dictionary_hash(const PoolByteArray &data);
+
 	NodePath get_player_path() const;
 	void set_player_path(const NodePath &player_path);
 
@@ -136,6 +214,8 @@ public:
 	void chunk_add(Ref<VoxelChunk> chunk, const int x, const int y, const int z);
 	bool chunk_has(const int x, const int y, const int z) const;
 	Ref<VoxelChunk> chunk_get(const int x, const int y, const int z);
+	//Use this from worker threads, it doesn't update the chunk's last access
+	Ref<VoxelChunk> chunk_get_threaded(const int x, const int y, const int z) const;
 	Ref<VoxelChunk> chunk_remove(const int x, const int y, const int z);
 	Ref<VoxelChunk> chunk_remove_index(const int index);
 	Ref<VoxelChunk> chunk_get_index(const int index);
@@ -149,19 +229,61 @@ public:
 	void chunk_setup(Ref<VoxelChunk> chunk);
 
 	void chunk_generate(Ref<VoxelChunk> chunk);
+	//Only fills the channels, dropped chunks use this to get their data back
+	void chunk_generate_data(Ref<VoxelChunk> chunk);
+
+	//Sparse storage. Generated chunks that only contain one value per channel are stored as vertical runs
+	//per column instead of VoxelChunk instances. They get recreated by chunk_get_or_create().
+	bool chunk_is_sparse(const int x, const int y, const int z) const;
+	int sparse_get_chunk_count() const;
+	int sparse_get_run_count() const;
+	int sparse_get_memory_usage() const;
+	void sparse_clear();
+	//x, y, z triplets of every sparse chunk
+	PoolIntArray sparse_get_positions() const;
+	//One value per channel, empty if the chunk isn't sparse
+	PoolByteArray sparse_get_values(const int x, const int y, const int z) const;
+
+	int64_t get_memory_usage() const;
+	int memory_budget_enforce();
+
+	//Builds (and sets) compression_dictionary from samples of the loaded chunks
+	PoolByteArray compression_dictionary_train(const int max_size = 65536);
+
+	//Streaming. Keeps the chunks inside chunk_spawn_range around the player loaded,
+	//and unloads them when they get further than chunk_spawn_range + chunk_despawn_margin.
+	void streaming_update();
+	void streaming_reset();
+
+	//Region store. Streamed chunks are loaded from it before falling back to generation, and saved into it when they get unloaded.
+	int region_store_save();
 
 	Vector<Variant> chunks_get();
 	void chunks_set(const Vector<Variant> &chunks);
 
+	//Active lists, only the chunks in these get processed every frame. VoxelChunk adds itself
+	//when it's flags get turned on, chunks are dropped when the world sees that their flag was turned off.
+	void active_process_add(VoxelChunk *chunk);
+	void active_physics_process_add(VoxelChunk *chunk);
+	void active_generating_add(VoxelChunk *chunk);
+
+	//Edits mark chunks dirty, they get rebuilt at most once per flush
+	void chunk_mark_dirty(const Ref<VoxelChunk> &chunk);
+	int dirty_get_count() const;
+	void dirty_flush();
+
 	bool can_chunk_do_build_step();
 	bool is_position_walkable(const Vector3 &p_pos);
 
 	void on_chunk_mesh_generation_finished(Ref<VoxelChunk> p_chunk);
 
+	//The generation queue is a binary heap, ordered by the distance to the player, chunks in front of it come first.
+	//Indices are in heap order.
 	void generation_queue_add_to(const Ref<VoxelChunk> &chunk);
 	Ref<VoxelChunk> generation_queue_get_index(const int index);
 	void generation_queue_remove_index(const int index);
 	int generation_queue_get_size() const;
+	void generation_queue_update_priorities();
 
 	void generation_add_to(const Ref<VoxelChunk> &chunk);
 	Ref<VoxelChunk> generation_get_index(const int index);
@@ -185,6 +307,18 @@ public:
 	//Helpers
 	uint8_t get_voxel_at_world_position(const Vector3 &world_position, const int channel_index);
 	void set_voxel_at_world_position(const Vector3 &world_position, const uint8_t data, const int channel_index, const bool rebuild = true);
+
+	//Bulk edits, voxels are set if their center is inside the shape. Chunks, and their margins are written once,
+	//the touched chunks are returned, and are marked dirty if rebuild is true.
+	Array set_voxels_box(const AABB &world_box, const int data, const int channel_index, const bool rebuild = true);
+	Array set_voxels_sphere(const Vector3 &world_center, const float world_radius, const int data, const int channel_index, const bool rebuild = true);
+	Array set_voxels_batch(const PoolVector3Array &world_positions, const PoolIntArray &data, const int channel_index, const bool rebuild = true);
+
+	//Queries, they read the channel data directly, so they don't need colliders. Voxels are solid if they are not 0.
+	//Both return an empty Dictionary if nothing was hit.
+	Dictionary raycast(const Vector3 &from, const Vector3 &direction, const float max_distance, const int channel_index);
+	Dictionary sweep_aabb(const AABB &world_box, const Vector3 &motion, const int channel_index);
+
 	Ref<VoxelChunk> get_chunk_at_world_position(const Vector3 &world_position);
 	Ref<VoxelChunk> get_or_create_chunk_at_world_position(const Vector3 &world_position);
 	void set_voxel_with_tool(const bool mode_add, const Vector3 hit_position, const Vector3 hit_normal, const int selected_voxel, const int isolevel);
@@ -228,14 +362,130 @@ public:
 		}
 	};
 
+	struct SparseRun {
+		int y_start;
+		int y_end;
+		int value_index;
+
+		SparseRun() {
+			y_start = 0;
+			y_end = 0;
+			value_index = 0;
+		}
+	};
+
+	struct GenerationQueueEntry {
+		Ref<VoxelChunk> chunk;
+		float priority;
+		uint32_t sequence;
+
+		_FORCE_INLINE_ bool operator<(const GenerationQueueEntry &other) const {
+			if (priority == other.priority)
+				return sequence < other.sequence;
+
+			return priority < other.priority;
+		}
+	};
+
+#if !THREAD_POOL_PRESENT
+	struct SlicedJobEntry {
+		Ref<VoxelJob> job;
+		float priority;
+		uint32_t sequence;
+
+		_FORCE_INLINE_ bool operator<(const SlicedJobEntry &other) const {
+			if (priority == other.priority)
+				return sequence < other.sequence;
+
+			return priority < other.priority;
+		}
+	};
+#endif
+
+	struct IntPosDistanceComparator {
+		_FORCE_INLINE_ bool operator()(const IntPos &a, const IntPos &b) const {
+			return a.x * a.x + a.y * a.y + a.z * a.z < b.x * b.x + b.y * b.y + b.z * b.z;
+		}
+	};
+
 	struct IntPosHasher {
 		static _FORCE_INLINE_ uint32_t hash(const IntPos &v) {
-			uint32_t hash = hash_djb2_one_32(v.x);
-			hash = hash_djb2_one_32(v.y, hash);
-			return hash_djb2_one_32(v.z, hash);
+			return VoxelChunkMap::hash(v.x, v.y, v.z);
 		}
 	};
 
+	struct RegionLoad {
+		Ref<VoxelChunk> chunk;
+		//Results arrive in request order, only the last one belongs to chunk
+		int requests;
+
+		RegionLoad() {
+			requests = 0;
+		}
+	};
+
+	struct VoxelQueryCache {
+		IntPos position;
+		Ref<VoxelChunk> chunk;
+		int uniform_value;
+		bool valid;
+
+		VoxelQueryCache() {
+			uniform_value = 0;
+			valid = false;
+		}
+	};
+
+protected:
+	void _chunk_generate(Ref<VoxelChunk> chunk, const PoolByteArray &delta);
+	void _region_store_poll();
+	void _region_loading_cancel(const bool forget);
+	Ref<VoxelChunk> _chunk_remove(const Ref<VoxelChunk> &chunk);
+	bool _chunk_is_regenerable(VoxelChunk *chunk) const;
+	bool _memory_budget_can_evict(VoxelChunk *chunk) const;
+	void _chunk_attach(const Ref<VoxelChunk> &chunk);
+	void _chunk_detach(const Ref<VoxelChunk> &chunk);
+
+	uint16_t _query_voxel(const int x, const int y, const int z, const int channel_index, VoxelQueryCache &cache);
+
+	Array _set_voxels_region(const int *min, const int *max, const bool sphere, const Vector3 &center, const float radius_squared, const int data, const int channel_index, const bool rebuild);
+
+	bool _chunks_vector_has(const Ref<VoxelChunk> &chunk) const;
+	void _chunks_vector_remove(const int index);
+
+	void _active_list_add(Vector<Ref<VoxelChunk> > &list, VoxelChunk *chunk, const int flag);
+	void _active_list_remove(Vector<Ref<VoxelChunk> > &list, const int index, const int flag);
+	void _active_list_erase(Vector<Ref<VoxelChunk> > &list, const Ref<VoxelChunk> &chunk, const int flag);
+	void _active_lists_erase(const Ref<VoxelChunk> &chunk);
+
+	//The process, physics process, generating, and dirty flags are the lowest bits, chunks store their index for each
+	static _FORCE_INLINE_ int _active_list_slot(const int flag) {
+		return nearest_shift(flag) - 1;
+	}
+
+	bool _generation_update_view();
+	float _generation_get_priority(const Ref<VoxelChunk> &chunk) const;
+	void _generation_queue_rebuild();
+#if !THREAD_POOL_PRESENT
+	void _sliced_jobs_process();
+	void _sliced_jobs_clear();
+#endif
+	Ref<VoxelChunk> _generation_queue_pop();
+	void _generation_queue_remove(const int index);
+	void _generation_queue_sift_up(int index);
+	void _generation_queue_sift_down(int index);
+
+	void _streaming_build_offsets();
+	bool _streaming_in_range(const int dx, const int dy, const int dz, const int margin) const;
+	bool _streaming_unload(const IntPos &pos);
+	void _streaming_chunk_removed(const int x, const int y, const int z);
+
+	bool _sparse_store(const Ref<VoxelChunk> &chunk);
+	int _sparse_get(const int x, const int y, const int z) const;
+	void _sparse_set(const int x, const int y, const int z, const int value_index);
+	void _sparse_erase(const int x, const int y, const int z);
+	Ref<VoxelChunk> _sparse_materialize(const int x, const int y, const int z);
+
 private:
 	bool _editable;
 
@@ -247,15 +497,73 @@ private:
 	int _current_seed;
 	int _data_margin_start;
 	int _data_margin_end;
+	int _data_layout;
 
 	Ref<VoxelmanLibrary> _library;
 	Ref<VoxelmanLevelGenerator> _level_generator;
+	Ref<VoxelBufferPool> _buffer_pool;
 	float _voxel_scale;
 	int _chunk_spawn_range;
-
-	HashMap<IntPos, Ref<VoxelChunk>, IntPosHasher> _chunks;
+	int _chunk_spawn_range_y;
+	int _chunk_despawn_margin;
+
+	bool _streaming;
+	int _streaming_shape;
+	bool _streaming_has_center;
+	IntPos _streaming_center;
+	//Spawn range offsets, nearest first
+	Vector<IntPos> _streaming_offsets;
+	//Offsets on the edge of the spawn (nearest first), and despawn ranges.
+	//Moving to a neighbouring chunk only changes which chunks are in range on these.
+	Vector<IntPos> _streaming_spawn_shell;
+	Vector<IntPos> _streaming_despawn_shell;
+	bool _streaming_offsets_dirty;
+	int _streaming_cursor;
+	//Set when the cursor walks the spawn shell instead of every offset
+	bool _streaming_walk_shell;
+	//Chunks that were still generating when they left the range
+	Vector<IntPos> _streaming_unload_pending;
+	//Chunks that were removed inside the range, not by streaming
+	Vector<IntPos> _streaming_refill;
+
+	VoxelChunkMap _chunks;
 	Vector<Ref<VoxelChunk> > _chunks_vector;
 
+	Vector<Ref<VoxelChunk> > _active_process;
+	Vector<Ref<VoxelChunk> > _active_physics_process;
+	Vector<Ref<VoxelChunk> > _active_generating;
+	Vector<Ref<VoxelChunk> > _dirty_chunks;
+	float _dirty_flush_interval;
+	float _dirty_flush_timer;
+
+	bool _sparse_storage;
+	//Keyed by IntPos(x, 0, z), runs are sorted by y
+	HashMap<IntPos, Vector<SparseRun>, IntPosHasher> _sparse_columns;
+	//Every distinct per channel value set, runs index into this
+	Vector<Vector<uint8_t> > _sparse_values;
+	int _sparse_chunk_count;
+	int _sparse_run_count;
+
+	//In bytes, 0 means unlimited
+	int64_t _memory_budget;
+	//Set when a pass couldn't evict anything, so it's not repeated every frame
+	bool _memory_budget_stalled;
+	//Every chunk adds it's allocations to this, so checking the budget doesn't need to walk the chunks
+	SafeNumeric<uint64_t> _chunks_memory_usage;
+	//Least recently accessed first
+	SelfList<VoxelChunk>::List _chunks_lru;
+
+	Ref<VoxelRegionStore> _region_store;
+	HashMap<IntPos, RegionLoad, IntPosHasher> _region_loading;
+
+	Ref<VoxelWorldPack> _world_pack;
+
+	//Every dictionary that was used, including the current one
+	HashMap<uint64_t, PoolByteArray> _compression_dictionaries;
+	uint64_t _compression_dictionary_hash;
+	//Workers compress, and decompress while the dictionary might get replaced
+	mutable Mutex _compression_dictionary_mutex;
+
 	Vector<Ref<WorldArea> > _world_areas;
 
 	Vector<Ref<VoxelStructure> > _voxel_structures;
@@ -265,9 +573,20 @@ private:
 
 	bool _use_threads;
 	int _max_concurrent_generations;
-	Vector<Ref<VoxelChunk> > _generation_queue;
+	Vector<GenerationQueueEntry> _generation_queue;
+	uint32_t _generation_queue_sequence;
+	bool _generation_has_view;
+	IntPos _generation_center;
+	Vector3 _generation_forward;
 	Vector<Ref<VoxelChunk> > _generating;
 	int _max_frame_chunk_build_steps;
+
+#if !THREAD_POOL_PRESENT
+	float _job_frame_budget;
+	//Binary min heap, same as the generation queue. Priorities are calculated when the jobs are added.
+	Vector<SlicedJobEntry> _sliced_jobs;
+	uint32_t _sliced_jobs_sequence;
+#endif
 	int _num_frame_chunk_build_steps;
 
 	Vector<Ref<VoxelLight> > _lights;
@@ -278,5 +597,6 @@ _FORCE_INLINE_ bool operator==(const VoxelWorld::IntPos &a, const VoxelWorld::In
 }
 
 VARIANT_ENUM_CAST(VoxelWorld::ChannelTypeInfo);
+VARIANT_ENUM_CAST(VoxelWorld::StreamingShape);
 
 #endif
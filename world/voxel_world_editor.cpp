@@ -81,11 +81,34 @@ bool VoxelWorldEditor::do_input_action(Camera *p_camera, const Point2 &p_point,
 	from = local_xform.xform(from);
 	to = local_xform.xform(to);
 
-	PhysicsDirectSpaceState *ss = _world->GET_WORLD()->get_direct_space_state();
+	Vector3 hit_position;
+	Vector3 hit_normal;
+	bool hit = false;
+
+	//Try the voxel data first, so chunks without colliders can be edited too
+	if (_channel_type != -1) {
+		Dictionary vres = _world->raycast(from, to - from, from.distance_to(to), _channel_type);
+
+		if (vres.size() > 0) {
+			hit_position = vres["position"];
+			hit_normal = vres["normal"];
+			hit = true;
+		}
+	}
+
+	if (!hit) {
+		PhysicsDirectSpaceState *ss = _world->GET_WORLD()->get_direct_space_state();
 
-	PhysicsDirectSpaceState::RayResult res;
+		PhysicsDirectSpaceState::RayResult res;
+
+		if (ss->intersect_ray(from, to, res)) {
+			hit_position = res.position;
+			hit_normal = res.normal;
+			hit = true;
+		}
+	}
 
-	if (ss->intersect_ray(from, to, res)) {
+	if (hit) {
 		int selected_voxel = 0;
 		int channel = 0;
 
@@ -106,7 +129,7 @@ bool VoxelWorldEditor::do_input_action(Camera *p_camera, const Point2 &p_point,
 			mode_add = false;
 		}
 
-		_world->set_voxel_with_tool(mode_add, res.position, res.normal, selected_voxel, isolevel);
+		_world->set_voxel_with_tool(mode_add, hit_position, hit_normal, selected_voxel, isolevel);
 
 		return true;
 	}
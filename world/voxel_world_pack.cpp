@@ -0,0 +1,364 @@
+/*
+Copyright (c) 2019-2020 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "voxel_world_pack.h"
+
+#include "core/io/marshalls.h"
+#include "core/os/file_access.h"
+
+#if VERSION_MAJOR > 3
+#include "core/config/project_settings.h"
+#else
+#include "core/project_settings.h"
+#endif
+
+#include "voxel_chunk.h"
+#include "voxel_world.h"
+
+#if defined(UNIX_ENABLED)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(WINDOWS_ENABLED)
+#include <windows.h>
+#endif
+
+String VoxelWorldPack::get_path() const {
+	return _path;
+}
+
+Error VoxelWorldPack::open(const String &path) {
+	ERR_FAIL_COND_V_MSG(is_open(), ERR_ALREADY_IN_USE, "Error, the pack is already open!");
+
+	if (!_map_file(path)) {
+		FileAccess *f = FileAccess::open(path, FileAccess::READ);
+
+		ERR_FAIL_COND_V_MSG(!f, ERR_FILE_CANT_OPEN, "Error, can't open " + path + "!");
+
+		_buffer.resize(f->get_len());
+		f->get_buffer(_buffer.ptrw(), _buffer.size());
+		memdelete(f);
+
+		_data = _buffer.ptr();
+		_size = _buffer.size();
+	}
+
+	if (_size < PACK_FILE_HEADER_SIZE || decode_uint32(_data) != PACK_FILE_MAGIC || decode_uint32(_data + 4) != PACK_FILE_VERSION) {
+		_close();
+		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, "Error, " + path + " is not a world pack, or it has a different version!");
+	}
+
+	_chunk_count = decode_uint32(_data + 8);
+
+	if (_size < PACK_FILE_HEADER_SIZE + static_cast<uint64_t>(_chunk_count) * PACK_INDEX_ENTRY_SIZE) {
+		_close();
+		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, "Error, " + path + " is truncated!");
+	}
+
+	_path = path;
+
+	return OK;
+}
+bool VoxelWorldPack::is_open() const {
+	return _data != NULL;
+}
+bool VoxelWorldPack::is_mapped() const {
+	return _mapped;
+}
+
+int VoxelWorldPack::get_chunk_count() const {
+	return _chunk_count;
+}
+bool VoxelWorldPack::has_chunk(const int x, const int y, const int z) const {
+	return _find(x, y, z) != -1;
+}
+
+bool VoxelWorldPack::chunk_map(Ref<VoxelChunk> chunk) {
+	ERR_FAIL_COND_V(!chunk.is_valid(), false);
+
+	int index = _find(chunk->get_position_x(), chunk->get_position_y(), chunk->get_position_z());
+
+	if (index == -1)
+		return false;
+
+	const uint8_t *entry = _data + PACK_FILE_HEADER_SIZE + index * PACK_INDEX_ENTRY_SIZE;
+
+	uint32_t size = decode_uint32(entry + 12);
+	uint64_t offset = decode_uint64(entry + 16);
+
+	ERR_FAIL_COND_V_MSG(offset > _size || size > _size - offset, false, "Error, " + _path + " is corrupt!");
+
+	return chunk->data_map(_data + offset, size, Ref<Reference>(this));
+}
+
+Error VoxelWorldPack::save(Node *world, const String &path) {
+	VoxelWorld *w = Object::cast_to<VoxelWorld>(world);
+
+	ERR_FAIL_COND_V(!w, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(is_open() && path == _path, ERR_BUSY, "Error, the pack can't overwrite itself while it's open!");
+
+	Vector<IndexEntry> entries;
+
+	for (int i = 0; i < w->chunk_get_count(); ++i) {
+		Ref<VoxelChunk> chunk = w->chunk_get_index(i);
+
+		if (!chunk.is_valid())
+			continue;
+
+		IndexEntry e;
+		e.x = chunk->get_position_x();
+		e.y = chunk->get_position_y();
+		e.z = chunk->get_position_z();
+		//Builds calculate the derived channels again
+		e.data = chunk->data_serialize(false);
+
+		entries.push_back(e);
+	}
+
+	//Sparse chunks only exist as values, they get written as uniform chunks
+	PoolIntArray sparse = w->sparse_get_positions();
+
+	if (sparse.size() > 0) {
+		Ref<VoxelChunk> chunk;
+		chunk.instance();
+		chunk->set_data_layout(w->get_data_layout());
+		chunk->set_size(w->get_chunk_size_x(), w->get_chunk_size_y(), w->get_chunk_size_z(), w->get_data_margin_start(), w->get_data_margin_end());
+
+		for (int i = 0; i + 2 < sparse.size(); i += 3) {
+			IndexEntry e;
+			e.x = sparse[i];
+			e.y = sparse[i + 1];
+			e.z = sparse[i + 2];
+
+			PoolByteArray values = w->sparse_get_values(e.x, e.y, e.z);
+
+			ERR_FAIL_COND_V_MSG(values.size() == 0, ERR_INVALID_DATA, "Error, can't read a sparse chunk's values!");
+
+			chunk->channel_set_count(values.size());
+
+			for (int j = 0; j < values.size(); ++j) {
+				chunk->channel_fill(values[j], j);
+			}
+
+			e.data = chunk->data_serialize(false);
+
+			entries.push_back(e);
+		}
+	}
+
+	//Lookups are binary searches in the index
+	entries.sort();
+
+	FileAccess *f = FileAccess::open(path, FileAccess::WRITE);
+
+	ERR_FAIL_COND_V_MSG(!f, ERR_FILE_CANT_OPEN, "Error, can't open " + path + "!");
+
+	f->store_32(PACK_FILE_MAGIC);
+	f->store_32(PACK_FILE_VERSION);
+	f->store_32(entries.size());
+	f->store_32(0);
+
+	uint64_t offset = PACK_FILE_HEADER_SIZE + static_cast<uint64_t>(entries.size()) * PACK_INDEX_ENTRY_SIZE;
+
+	for (int i = 0; i < entries.size(); ++i) {
+		const IndexEntry &e = entries[i];
+
+		f->store_32(e.x);
+		f->store_32(e.y);
+		f->store_32(e.z);
+		f->store_32(e.data.size());
+		f->store_64(offset);
+
+		offset += e.data.size();
+	}
+
+	for (int i = 0; i < entries.size(); ++i) {
+		const PoolByteArray &data = entries[i].data;
+
+#if !GODOT4
+		PoolByteArray::Read r = data.read();
+		f->store_buffer(r.ptr(), data.size());
+#else
+		f->store_buffer(data.ptr(), data.size());
+#endif
+	}
+
+	memdelete(f);
+
+	return OK;
+}
+
+VoxelWorldPack::VoxelWorldPack() {
+	_data = NULL;
+	_size = 0;
+	_chunk_count = 0;
+	_mapped = false;
+
+#ifdef WINDOWS_ENABLED
+	_file_handle = NULL;
+	_mapping_handle = NULL;
+#endif
+}
+
+VoxelWorldPack::~VoxelWorldPack() {
+	_close();
+}
+
+int VoxelWorldPack::_find(const int x, const int y, const int z) const {
+	if (!_data)
+		return -1;
+
+	const uint8_t *index = _data + PACK_FILE_HEADER_SIZE;
+
+	int low = 0;
+	int high = _chunk_count - 1;
+
+	while (low <= high) {
+		int mid = (low + high) / 2;
+		const uint8_t *entry = index + mid * PACK_INDEX_ENTRY_SIZE;
+
+		int ex = static_cast<int>(decode_uint32(entry));
+		int ey = static_cast<int>(decode_uint32(entry + 4));
+		int ez = static_cast<int>(decode_uint32(entry + 8));
+
+		if (ex == x && ey == y && ez == z)
+			return mid;
+
+		if (ex < x || (ex == x && (ey < y || (ey == y && ez < z))))
+			low = mid + 1;
+		else
+			high = mid - 1;
+	}
+
+	return -1;
+}
+
+bool VoxelWorldPack::_map_file(const String &path) {
+	String real_path = ProjectSettings::get_singleton()->globalize_path(path);
+
+	//Private, writable pages, so even a write that skips the chunk's copy on write can't change the file
+#if defined(UNIX_ENABLED)
+	int fd = ::open(real_path.utf8().get_data(), O_RDONLY);
+
+	if (fd == -1)
+		return false;
+
+	struct stat st;
+
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+
+	void *data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+	//The mapping stays valid after the descriptor is closed
+	::close(fd);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	_data = reinterpret_cast<const uint8_t *>(data);
+	_size = st.st_size;
+	_mapped = true;
+
+	return true;
+#elif defined(WINDOWS_ENABLED)
+#if !GODOT4
+	HANDLE file = CreateFileW(real_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+#else
+	HANDLE file = CreateFileW((LPCWSTR)real_path.utf16().get_data(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+#endif
+
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+
+	if (mapping == NULL) {
+		CloseHandle(file);
+		return false;
+	}
+
+	void *data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+
+	if (data == NULL) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	_file_handle = file;
+	_mapping_handle = mapping;
+	_data = reinterpret_cast<const uint8_t *>(data);
+	_size = size.QuadPart;
+	_mapped = true;
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+void VoxelWorldPack::_close() {
+	if (_mapped) {
+#if defined(UNIX_ENABLED)
+		munmap(const_cast<uint8_t *>(_data), _size);
+#elif defined(WINDOWS_ENABLED)
+		UnmapViewOfFile(_data);
+		CloseHandle(_mapping_handle);
+		CloseHandle(_file_handle);
+
+		_mapping_handle = NULL;
+		_file_handle = NULL;
+#endif
+	}
+
+	_buffer.clear();
+
+	_data = NULL;
+	_size = 0;
+	_chunk_count = 0;
+	_mapped = false;
+}
+
+void VoxelWorldPack::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_path"), &VoxelWorldPack::get_path);
+
+	ClassDB::bind_method(D_METHOD("open", "path"), &VoxelWorldPack::open);
+	ClassDB::bind_method(D_METHOD("is_open"), &VoxelWorldPack::is_open);
+	ClassDB::bind_method(D_METHOD("is_mapped"), &VoxelWorldPack::is_mapped);
+
+	ClassDB::bind_method(D_METHOD("get_chunk_count"), &VoxelWorldPack::get_chunk_count);
+	ClassDB::bind_method(D_METHOD("has_chunk", "x", "y", "z"), &VoxelWorldPack::has_chunk);
+	ClassDB::bind_method(D_METHOD("chunk_map", "chunk"), &VoxelWorldPack::chunk_map);
+
+	ClassDB::bind_method(D_METHOD("save", "world", "path"), &VoxelWorldPack::save);
+}
@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2019-2020 Péter Magyar
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef VOXEL_WORLD_PACK_H
+#define VOXEL_WORLD_PACK_H
+
+#include "core/version.h"
+
+#if VERSION_MAJOR > 3
+#include "core/object/reference.h"
+#include "core/string/ustring.h"
+#include "core/templates/vector.h"
+#else
+#include "core/reference.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+#endif
+
+#include "../defines.h"
+
+#include pool_vector_h
+
+class Node;
+class VoxelChunk;
+
+//A read only file of chunks (VoxelChunk::data_serialize() without the derived channels), for shipped levels.
+//The file is memory mapped where possible, and mapped chunks reference their channel data in it directly,
+//so opening it costs the same regardless of the world's size. Chunks copy a channel when it is first written.
+//Falls back to reading the whole file when it can't be mapped (for example when it's inside a pck).
+class VoxelWorldPack : public Reference {
+	GDCLASS(VoxelWorldPack, Reference);
+
+public:
+	enum {
+		PACK_FILE_MAGIC = 0x50575856, //VXWP
+		PACK_FILE_VERSION = 1,
+		//magic, version, chunk count, reserved
+		PACK_FILE_HEADER_SIZE = 16,
+		//i32 x, y, z, u32 size, u64 offset, sorted by position
+		PACK_INDEX_ENTRY_SIZE = 24,
+	};
+
+	String get_path() const;
+
+	//Can only be opened once, chunks might still reference the data
+	Error open(const String &path);
+	bool is_open() const;
+	bool is_mapped() const;
+
+	int get_chunk_count() const;
+	bool has_chunk(const int x, const int y, const int z) const;
+
+	//Returns false if the chunk is not in the pack
+	bool chunk_map(Ref<VoxelChunk> chunk);
+
+	//Writes every loaded chunk of world
+	Error save(Node *world, const String &path);
+
+	VoxelWorldPack();
+	~VoxelWorldPack();
+
+protected:
+	static void _bind_methods();
+
+	struct IndexEntry {
+		int x;
+		int y;
+		int z;
+		PoolByteArray data;
+
+		bool operator<(const IndexEntry &other) const {
+			if (x != other.x)
+				return x < other.x;
+
+			if (y != other.y)
+				return y < other.y;
+
+			return z < other.z;
+		}
+	};
+
+	int _find(const int x, const int y, const int z) const;
+
+	bool _map_file(const String &path);
+	void _close();
+
+	String _path;
+
+	const uint8_t *_data;
+	uint64_t _size;
+	int _chunk_count;
+
+	bool _mapped;
+	Vector<uint8_t> _buffer;
+
+#ifdef WINDOWS_ENABLED
+	void *_file_handle;
+	void *_mapping_handle;
+#endif
+};
+
+#endif